@@ -3,214 +3,155 @@
 #include "Move.h"
 #include "MoveGenerator.h"
 #include "OpeningBook.h"
-#include "Pawn.h"
 #include "PieceBitBoards.h"
+#include "WorkStealingPool.h"
 
 #include <algorithm>
 
 namespace chessAi
 {
 
+Score Score::fromEvaluation(int evaluation)
+{
+    // Mate scores are offset by number of plies to mate.
+    if (std::abs(evaluation) >= Evaluate::mateThreshold) {
+        int movesToMate = (Evaluate::mateScore - std::abs(evaluation) + 1) / 2;
+        return {Type::Mate, evaluation > 0 ? movesToMate : -movesToMate};
+    }
+    return {Type::Centipawns, evaluation};
+}
+
 Engine::Engine(bool useBook, const std::chrono::milliseconds& timeLimit, unsigned int depthLimit)
-    : m_useOpeningBook(useBook), m_transpositionTable(), m_depthLimit(depthLimit),
-      m_currentIterativeDepth(0), m_depthSearched(0), m_countTranspositions(0),
-      m_countMaxCheckExtensions(0), m_timer(timeLimit), m_runSearch(false)
+    : m_openingBookLoaded(false), m_useOpeningBook(useBook), m_transpositionTable(),
+      m_depthLimit(depthLimit), m_nodeLimit(std::nullopt), m_depthSearched(0), m_multiPv(1),
+      m_probCut(true), m_timeControl(), m_timeManager(), m_runSearch(true), m_stopRequestTime(-1),
+      m_stopLatency(), m_ponderMove(), m_ponderReplies(1), m_ponderParent(), m_ponderRootIndices(),
+      m_speculativePonder(false), m_searches(), m_searchMode(SearchMode::LazySmp), m_infoCallback()
 {
+    m_timeControl.moveTime = timeLimit;
     if (m_useOpeningBook)
-        m_useOpeningBook = OpeningBook::Init();
+        m_openingBookLoaded = m_useOpeningBook = OpeningBook::Init();
+    setNumberOfThreads(1);
 }
 
-int Engine::evaluateEndGameType(const PieceBitBoards& bitBoards, int depth,
-                                unsigned int numCheckExtensions)
+void Engine::setNumberOfThreads(unsigned int numberOfThreads)
 {
-    if (bitBoards.currentMoveColor == PieceColor::White) {
-        // Must add depth so we find the shortest mate (mate pruning), also add check extensions.
-        if (MoveGenerator<PieceColor::White>::isKingInCheck(bitBoards))
-            return Evaluate::negativeMateScore + (m_currentIterativeDepth + numCheckExtensions) -
-                   depth;
-        return 0;
-    }
-    else {
-        if (MoveGenerator<PieceColor::Black>::isKingInCheck(bitBoards))
-            return Evaluate::negativeMateScore + (m_currentIterativeDepth + numCheckExtensions) -
-                   depth;
-        return 0;
-    }
+    numberOfThreads = std::max(numberOfThreads, 1u);
+    if (numberOfThreads == m_searches.size())
+        return;
+    m_searches.clear();
+    for (unsigned int i = 0; i < numberOfThreads; i++)
+        m_searches.push_back(
+            std::make_unique<Search>(m_transpositionTable, m_runSearch, m_timeManager, i));
 }
 
-int Engine::quiescenceSearch(const PieceBitBoards& bitBoards, int alpha, int beta, int depth)
+void Engine::setSearchMode(SearchMode searchMode)
 {
-    if (!m_runSearch)
-        return Evaluate::negativeInfinity;
-
-    auto evaluation = Evaluate::getEvaluation(bitBoards);
-
-    if (depth == 0)
-        return evaluation;
-
-    if (evaluation >= beta)
-        return beta;
-    alpha = std::max(evaluation, alpha);
-
-    PieceBitBoards tempBoards = bitBoards;
-    for (const auto& [moveScore, move] : orderMoves(
-             MoveGeneratorWrapper::generateLegalMoves<MoveType::Capture>(bitBoards), bitBoards)) {
-        tempBoards.applyMove(move);
-        evaluation = -quiescenceSearch(tempBoards, -beta, -alpha, depth - 1);
-        tempBoards = bitBoards;
-
-        if (evaluation >= beta)
-            return beta;
-        alpha = std::max(evaluation, alpha);
-    }
-
-    return alpha;
+    m_searchMode = searchMode;
 }
 
-int Engine::negamax(const PieceBitBoards& bitBoards, unsigned int depth, int alpha, int beta,
-                    unsigned int numCheckExtensions,
-                    const std::vector<uint64_t>& zobristKeysHistory)
+void Engine::clear()
 {
-    if (!m_runSearch)
-        return Evaluate::negativeInfinity;
-
-    int previousAlpha = alpha;
-
-    auto tableEval = m_transpositionTable.getEntry(bitBoards.zobristKey);
-
-    if (tableEval != nullptr && tableEval->depth >= depth) {
-        m_countTranspositions++;
-        if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::exact) {
-            return tableEval->evaluation;
-        }
-        else if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::lower) {
-            alpha = std::max(alpha, tableEval->evaluation);
-        }
-        else if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::upper) {
-            beta = std::min(beta, tableEval->evaluation);
-        }
-        else
-            CHESS_LOG_ERROR("Evaluation in table with node type none.");
-    }
-
-    if (alpha >= beta)
-        return tableEval->evaluation;
-
-    if (depth == 0)
-        // We pass alpha, beta and not -beta, -alpha because it is still our move.
-        return quiescenceSearch(bitBoards, alpha, beta);
-
-    std::vector<Move> moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(bitBoards);
+    m_transpositionTable.clear();
+    for (auto& search : m_searches)
+        search->clear();
+}
 
-    if (moves.empty())
-        return evaluateEndGameType(bitBoards, depth, numCheckExtensions);
+void Engine::setMultiPv(unsigned int multiPv)
+{
+    m_multiPv = std::max(multiPv, 1u);
+}
 
-    int bestEvaluation = Evaluate::negativeInfinity;
-    Move bestMove(0, 0, 0, 0);
-    PieceBitBoards tempBoards = bitBoards;
+void Engine::setTimeControl(const TimeControl& timeControl)
+{
+    m_timeControl = timeControl;
+    // Set here and not when search starts, so ponderhit received right after go is not lost.
+    m_timeManager.setPondering(timeControl.ponder);
+}
 
-    for (const auto& [moveScore, move] : orderMoves(moves, bitBoards)) {
-        tempBoards.applyMove(move);
+void Engine::setMoveOverhead(std::chrono::milliseconds moveOverhead)
+{
+    m_timeManager.setMoveOverhead(moveOverhead);
+}
 
-        int evaluation = 0;
+void Engine::setAdaptiveTimeManagement(bool adaptive)
+{
+    m_timeManager.setAdaptive(adaptive);
+}
 
-        // Detect 3 fold repetition.
-        if (std::count(zobristKeysHistory.begin(), zobristKeysHistory.end(),
-                       tempBoards.zobristKey) < 1) {
-            // Check extensions
-            bool extension = false;
-            // Limit check number of check extensions to 10.
-            if (numCheckExtensions <= 9) {
-                extension = (tempBoards.currentMoveColor == PieceColor::White)
-                                ? MoveGenerator<PieceColor::White>::isKingInCheck(tempBoards)
-                                : MoveGenerator<PieceColor::Black>::isKingInCheck(tempBoards);
-            }
-            m_countMaxCheckExtensions = std::max(numCheckExtensions, m_countMaxCheckExtensions);
+void Engine::setUseOpeningBook(bool useBook)
+{
+    m_useOpeningBook = useBook && m_openingBookLoaded;
+}
 
-            // Minus sign is needed because we evaluate the position from the perspective of current
-            // move color. Good for the opponent, bad for us.
-            evaluation = -negamax(tempBoards, depth - 1 + extension, -beta, -alpha,
-                                  numCheckExtensions + extension, zobristKeysHistory);
-        }
+void Engine::setProbCut(bool probCut)
+{
+    m_probCut = probCut;
+}
 
-        if (evaluation > bestEvaluation) {
-            bestEvaluation = evaluation;
-            bestMove = move;
-            alpha = std::max(evaluation, alpha);
-        }
+void Engine::setInfoCallback(std::function<void(const SearchInfo&)> infoCallback)
+{
+    m_infoCallback = std::move(infoCallback);
+}
 
-        if (alpha >= beta)
-            break;
+void Engine::stopSearch()
+{
+    int64_t notRequested = -1;
+    m_stopRequestTime.compare_exchange_strong(notRequested,
+                                              m_timeManager.getElapsedMicroseconds().count());
+    m_runSearch = false;
+}
 
-        tempBoards = bitBoards;
-    }
+void Engine::prepareSearch()
+{
+    m_stopRequestTime = -1;
+    m_runSearch = true;
+}
 
-    // Only store if leaf nodes were reached.
-    if (m_runSearch && !(bestMove == Move(0, 0, 0, 0))) {
-        auto nodeType = TranspositionTable::TypeOfNode::exact;
-        if (bestEvaluation <= previousAlpha)
-            nodeType = TranspositionTable::TypeOfNode::upper;
-        else if (bestEvaluation >= beta)
-            nodeType = TranspositionTable::TypeOfNode::lower;
-        m_transpositionTable.store(bitBoards.zobristKey, bestEvaluation, depth, nodeType, bestMove);
-    }
-    return bestEvaluation;
+void Engine::setPonderReplies(unsigned int numberOfReplies)
+{
+    m_ponderReplies = std::max(numberOfReplies, 1u);
 }
 
-std::pair<Move, bool> Engine::iterativeDeepening(const PieceBitBoards& bitBoards,
-                                                 unsigned int depth,
-                                                 const std::vector<uint64_t>& zobristKeysHistory)
+void Engine::setPonderParent(const PieceBitBoards& bitBoards,
+                             const std::vector<uint64_t>& zobristKeysHistory)
 {
-    std::vector<Move> moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(bitBoards);
-
-    int bestEvaluation = Evaluate::negativeMateScore;
-    Move bestMove(0, 0, 0, 0);
-    auto foundShortestMate = false;
-    PieceBitBoards tempBoards = bitBoards;
-
-    // Here we must guarantee that the best move from the previous iteration is searched first.
-    for (const auto& [moveScore, move] : orderMoves(moves, bitBoards)) {
-        tempBoards.applyMove(move);
-        int evaluation = 0;
-
-        // Detect 3 fold repetition.
-        if (std::count(zobristKeysHistory.begin(), zobristKeysHistory.end(),
-                       tempBoards.zobristKey) < 1) {
-            // Check extensions
-            bool extension = (tempBoards.currentMoveColor == PieceColor::White)
-                                 ? MoveGenerator<PieceColor::White>::isKingInCheck(tempBoards)
-                                 : MoveGenerator<PieceColor::Black>::isKingInCheck(tempBoards);
-            evaluation = -negamax(tempBoards, depth - 1 + extension, -Evaluate::infinity,
-                                  -bestEvaluation, extension, zobristKeysHistory);
-        }
+    m_ponderParent = RootPosition{bitBoards, zobristKeysHistory};
+}
 
-        // If search was canceled, evaluation from this negamax search didn't reach leaf nodes,
-        // evaluation is useless.
-        if (!m_runSearch)
-            break;
+void Engine::setDepthLimit(unsigned int depthLimit)
+{
+    m_depthLimit = depthLimit;
+}
 
-        if (evaluation > bestEvaluation) {
-            bestEvaluation = evaluation;
-            bestMove = move;
-        }
+void Engine::setNodeLimit(std::optional<uint64_t> nodeLimit)
+{
+    m_nodeLimit = nodeLimit;
+}
 
-        if (bestEvaluation >= Evaluate::mateScore - static_cast<int>(m_currentIterativeDepth)) {
-            foundShortestMate = true;
-            break;
+void Engine::ponderHit()
+{
+    m_timeManager.setPondering(false);
+    if (m_speculativePonder) {
+        for (size_t i = 0; i < m_ponderRootIndices.size(); i++) {
+            if (m_ponderRootIndices[i] != 0)
+                m_searches[i]->abort();
         }
-
-        tempBoards = bitBoards;
     }
+    CHESS_LOG_INFO("Ponderhit after {} ms.", m_timeManager.getElapsedTime().count());
+    // Pondering took longer than time for this move, best move so far is good enough.
+    if (m_timeManager.softLimitReached())
+        stopSearch();
+}
 
-    // Important for move ordering in iterative deepening, search previous move first. Do not store
-    // false evaluation.
-    if (m_runSearch && !(bestMove == Move(0, 0, 0, 0))) {
-        m_transpositionTable.store(bitBoards.zobristKey, bestEvaluation, depth,
-                                   TranspositionTable::TypeOfNode::exact, bestMove);
-        CHESS_LOG_INFO("Iterative deepening depth {} search evaluation: {}", depth, bestEvaluation);
-    }
+std::optional<Move> Engine::getPonderMove() const
+{
+    return m_ponderMove;
+}
 
-    return {bestMove, foundShortestMate};
+std::optional<std::chrono::microseconds> Engine::getStopLatency() const
+{
+    return m_stopLatency;
 }
 
 namespace
@@ -243,162 +184,232 @@ std::optional<Move> getBookMove(const std::vector<Move>& movesHistory,
 
 } // namespace
 
-std::pair<std::optional<Move>, unsigned int> Engine::findBestMove(
+SearchResult Engine::findBestMove(
     const PieceBitBoards& bitBoards, const std::vector<uint64_t>& zobristKeysHistory,
     const std::vector<Move>& movesHistory)
 {
     CHESS_LOG_INFO("Half move count: {}", bitBoards.halfMoveCount);
 
+    m_ponderMove.reset();
     if (m_useOpeningBook) {
         auto move = getBookMove(movesHistory, bitBoards);
-        if (move.has_value())
-            return {*move, 0};
+        if (move.has_value()) {
+            // Book move is found instantly, but best move must not be reported while pondering.
+            // Stop sent before this point is pending and ends the wait.
+            waitForPonderEnd();
+            m_ponderParent.reset();
+            prepareSearch();
+            return {*move, 0, 0, 0, {Score::Type::Centipawns, 0}, {*move}};
+        }
     }
 
-    m_runSearch = true;
-    m_timer.resetStartTime();
-    m_timerThread = std::thread(&Engine::runTimer, this);
-
-    Move bestMove(0, 0, 0, 0);
-
-    // Iterative deepening
-    for (unsigned int depth = 1; depth <= m_depthLimit; depth++) {
-        if (!m_runSearch)
-            break;
-        m_currentIterativeDepth = depth;
-        auto [bestMoveThisIteration, isShortestMate] =
-            iterativeDeepening(bitBoards, depth, zobristKeysHistory);
-
-        m_depthSearched = depth;
-        // We can update previous move even if search was canceled, because best move from
-        // previous iteration is searched first (and next move in the search must be searched to
-        // the leafs). We still have to check for null move, as it can be returned, if iterative
-        // deepening was canceled during first iteration.
-        if (bestMoveThisIteration == Move(0, 0, 0, 0))
-            continue;
-        bestMove = bestMoveThisIteration;
-        if (isShortestMate)
-            break;
+    // Entries of previous searches are kept, but replaced first.
+    m_transpositionTable.newSearch();
+
+    // Search threads check the clock themselves, every few thousand nodes.
+    m_timeManager.start(m_timeControl);
+    m_stopLatency.reset();
+    // Stop may already be pending, it is kept and counts from the start of the search.
+    int64_t pendingStopTime = m_stopRequestTime;
+    if (pendingStopTime > 0)
+        m_stopRequestTime.compare_exchange_strong(pendingStopTime, 0);
+    CHESS_LOG_INFO("Time limits soft: {} ms, hard: {} ms",
+                   m_timeManager.getSoftLimit().value_or(std::chrono::milliseconds(-1)).count(),
+                   m_timeManager.getHardLimit().value_or(std::chrono::milliseconds(-1)).count());
+
+    // Node limited search runs on the main thread only, so it stops at the same node and returns
+    // the same move with any number of threads.
+    auto numThreads = m_nodeLimit.has_value() ? size_t{1} : m_searches.size();
+    for (auto& search : m_searches) {
+        search->clearAbort();
+        search->resetStatistics();
+        search->setNodeLimit(m_nodeLimit);
+        search->setProbCut(m_probCut);
     }
 
-    CHESS_LOG_INFO("Number of transpositions: {}", m_countTranspositions);
-    CHESS_LOG_INFO("Number of max check extension: {}", m_countMaxCheckExtensions);
-    m_runSearch = false;
-    m_timerThread.join();
-    return {bestMove, m_depthSearched};
-}
-
-namespace
-{
-
-void scorePromotion(Move move, int& moveScore)
-{
-    if (move.specialMoveFlag == 1) {
-        if (move.promotion == 0)
-            moveScore += Evaluate::getFigureValue(PieceFigure::Knight);
-        if (move.promotion == 1)
-            moveScore += Evaluate::getFigureValue(PieceFigure::Bishop);
-        if (move.promotion == 2)
-            moveScore += Evaluate::getFigureValue(PieceFigure::Rook);
-        if (move.promotion == 3)
-            moveScore += Evaluate::getFigureValue(PieceFigure::Queen);
-    }
-}
-
-void pawnDefendedScore(Move move, int& moveScore, const PieceBitBoards& boards,
-                       PieceFigure movingPiece)
-{
-    uint64_t positionMask = 0;
-    uint64_t attack = 0;
-    if (boards.currentMoveColor == PieceColor::White) {
-        PieceBitBoards::setBit(positionMask, move.destination);
-        for (auto position : boards.blackPawnPositions) {
-            attack |= Pawn<PieceColor::Black>::originToAttacks[position];
+    // Speculative pondering, helper threads search other likely replies. Set up before checking
+    // pondering, so ponderhit received meanwhile still reassigns them.
+    std::vector<RootPosition> roots;
+    if (m_ponderParent.has_value() && m_ponderReplies > 1 && numThreads > 1 &&
+        m_searchMode == SearchMode::LazySmp) {
+        roots = selectPonderRoots(bitBoards, zobristKeysHistory);
+        m_ponderRootIndices.clear();
+        for (size_t i = 0; i < m_searches.size(); i++)
+            m_ponderRootIndices.push_back(i % roots.size());
+        m_speculativePonder = true;
+        if (!m_timeManager.isPondering()) {
+            m_speculativePonder = false;
+            roots.clear();
         }
-        if ((attack & positionMask) != 0)
-            moveScore -= Evaluate::getFigureValue(movingPiece);
+        else
+            CHESS_LOG_INFO("Speculative pondering on {} replies.", roots.size());
+    }
+    m_ponderParent.reset();
+
+    // Only the main thread searches MultiPV lines, helper threads search the best line.
+    m_searches[0]->setMultiPv(m_multiPv);
+
+    // Lazy SMP helper threads only fill the shared transposition table, Young Brothers Wait workers
+    // search moves of split points. In both modes main thread reports the best move.
+    std::vector<std::thread> helperThreads;
+    std::unique_ptr<WorkStealingPool> threadPool;
+    if (m_searchMode == SearchMode::YoungBrothersWait && numThreads > 1) {
+        threadPool = std::make_unique<WorkStealingPool>(m_searches);
+        for (auto& search : m_searches)
+            search->setThreadPool(threadPool.get());
     }
     else {
-        PieceBitBoards::setBit(positionMask, move.destination);
-        for (auto position : boards.whitePawnPositions) {
-            attack |= Pawn<PieceColor::White>::originToAttacks[position];
+        for (size_t i = 1; i < numThreads; i++) {
+            helperThreads.emplace_back([this, i, &bitBoards, &zobristKeysHistory, &roots]() {
+                // Search speculative root until ponderhit, then help with the expected reply.
+                if (!roots.empty() && i % roots.size() != 0) {
+                    const auto& root = roots[i % roots.size()];
+                    m_searches[i]->run(root.bitBoards, root.zobristKeysHistory, m_depthLimit, {});
+                    m_searches[i]->clearAbort();
+                }
+                m_searches[i]->run(bitBoards, zobristKeysHistory, m_depthLimit, {});
+            });
         }
-        if ((attack & positionMask) != 0)
-            moveScore -= Evaluate::getFigureValue(movingPiece);
     }
-}
 
-} // namespace
+    auto result = m_searches[0]->run(
+        bitBoards, zobristKeysHistory, m_depthLimit,
+        [this, numThreads](const Search::IterationInfo& info) {
+            auto time = m_timeManager.getElapsedTime();
+            auto nodes = getCountNodes();
+            if (info.bound == TranspositionTable::TypeOfNode::exact && info.multiPv == 1)
+                CHESS_LOG_INFO("Depth {} reached in {} ms with {} threads, {} nodes.", info.depth,
+                               time.count(), numThreads, nodes);
+            if (m_infoCallback)
+                m_infoCallback({info.depth, info.evaluation, Score::fromEvaluation(info.evaluation),
+                                info.bound, time, nodes, info.multiPv, info.pv});
+            // Time is managed by the best line, lines are reported after all are searched.
+            if (info.bound != TranspositionTable::TypeOfNode::exact || info.multiPv != 1)
+                return;
+            // Next depth would most likely not finish before (scaled) soft limit.
+            m_timeManager.onIterationCompleted(info.bestMove, info.evaluation,
+                                               info.bestMoveNodesFraction);
+            if (m_timeManager.softLimitReached())
+                stopSearch();
+        });
+    m_depthSearched = result.depth;
+    // Search can end by itself (depth limit, shortest mate) while pondering.
+    waitForPonderEnd();
 
-[[nodiscard]] std::multimap<int, Move, std::greater<int>> Engine::orderMoves(
-    const std::vector<Move>& moves, const PieceBitBoards& boards, bool useTranspositions)
-{
-    Move bestMove(0, 0, 0, 0);
-
-    // Important so best move from previous search is searched first.
-    if (useTranspositions) {
-        auto entry = m_transpositionTable.getEntry(boards.zobristKey);
-        if (entry != nullptr)
-            bestMove = entry->bestMove;
+    m_runSearch = false;
+    for (auto& thread : helperThreads)
+        thread.join();
+    m_speculativePonder = false;
+    if (threadPool != nullptr) {
+        for (auto& search : m_searches)
+            search->setThreadPool(nullptr);
+        threadPool.reset();
     }
 
-    std::multimap<int, Move, std::greater<int>> sortedMoves;
-
-    for (auto move : moves) {
-        int moveScore = 0;
-
-        if (move == bestMove) {
-            moveScore = 100000;
-            sortedMoves.insert({moveScore, move});
-            continue;
-        }
-
-        auto movingPiece = boards.getPieceTypeWithSetBitAtPosition(move.origin);
-        if (movingPiece.getPieceFigure() == PieceFigure::Empty) {
-            CHESS_LOG_ERROR("No piece at origin of move.");
-            continue;
-        }
-        auto capturedPiece = boards.getPieceTypeWithSetBitAtPosition(move.destination);
-
-        // MVV-LVA, offset a bit so captures still score high
-        if (capturedPiece.getPieceFigure() != PieceFigure::Empty)
-            moveScore = Evaluate::getFigureValue(capturedPiece.getPieceFigure()) -
-                        Evaluate::getFigureValue(movingPiece.getPieceFigure());
-
-        scorePromotion(move, moveScore);
-        pawnDefendedScore(move, moveScore, boards, movingPiece.getPieceFigure());
-
-        sortedMoves.insert({moveScore, move});
+    // Stop latency, from stop request (or hard limit) until all search threads returned.
+    auto finishTime = m_timeManager.getElapsedMicroseconds();
+    auto hardLimit = m_timeManager.getHardLimit();
+    if (m_stopRequestTime >= 0)
+        m_stopLatency = finishTime - std::chrono::microseconds(m_stopRequestTime);
+    else if (hardLimit.has_value() && finishTime >= *hardLimit)
+        m_stopLatency = finishTime - std::chrono::microseconds(*hardLimit);
+    if (m_stopLatency.has_value())
+        CHESS_LOG_INFO("Stop latency: {} us", m_stopLatency->count());
+    if (m_timeManager.getSoftLimit().has_value())
+        CHESS_LOG_INFO("Soft limit: {} ms, time used: {} ms",
+                       m_timeManager.getSoftLimit()->count(),
+                       m_timeManager.getElapsedTime().count());
+
+    unsigned int countTranspositions = 0;
+    unsigned int countMaxCheckExtensions = 0;
+    unsigned int countInternalIterativeDeepening = 0;
+    unsigned int countInternalIterativeReductions = 0;
+    unsigned int countSingularExtensions = 0;
+    uint64_t countProbCutTries = 0;
+    uint64_t countProbCuts = 0;
+    uint64_t countCutoffs = 0;
+    uint64_t sumCutoffMoveNumbers = 0;
+    for (const auto& search : m_searches) {
+        countTranspositions += search->getCountTranspositions();
+        countMaxCheckExtensions =
+            std::max(countMaxCheckExtensions, search->getCountMaxCheckExtensions());
+        countInternalIterativeDeepening += search->getCountInternalIterativeDeepening();
+        countInternalIterativeReductions += search->getCountInternalIterativeReductions();
+        countSingularExtensions += search->getCountSingularExtensions();
+        countProbCutTries += search->getCountProbCutTries();
+        countProbCuts += search->getCountProbCuts();
+        countCutoffs += search->getCountCutoffs();
+        sumCutoffMoveNumbers += search->getSumCutoffMoveNumbers();
     }
-    return sortedMoves;
+    CHESS_LOG_INFO("Number of transpositions: {}", countTranspositions);
+    CHESS_LOG_INFO("Number of max check extension: {}", countMaxCheckExtensions);
+    CHESS_LOG_INFO("Number of internal iterative deepening searches: {}, reductions: {}",
+                   countInternalIterativeDeepening, countInternalIterativeReductions);
+    CHESS_LOG_INFO("Number of singular extensions: {}", countSingularExtensions);
+    CHESS_LOG_INFO("ProbCut cutoffs: {} of {} verified captures ({:.1f}%)", countProbCuts,
+                   countProbCutTries,
+                   100.0 * static_cast<double>(countProbCuts) /
+                       static_cast<double>(std::max(countProbCutTries, uint64_t{1})));
+    CHESS_LOG_INFO("Average beta cutoff move number: {:.3f}",
+                   static_cast<double>(sumCutoffMoveNumbers) /
+                       static_cast<double>(std::max(countCutoffs, uint64_t{1})));
+    auto time = static_cast<uint64_t>(m_timeManager.getElapsedTime().count()) + 1;
+    auto nodes = getCountNodes();
+    auto nodesPerSecond = nodes * 1000 / time;
+    CHESS_LOG_INFO("Nodes: {}, nodes per second: {}", nodes, nodesPerSecond);
+
+    // Stop of this search doesn't carry over to the next findBestMove called from this thread.
+    prepareSearch();
+
+    auto score = Score::fromEvaluation(result.evaluation);
+    if (result.bestMove == Move(0, 0, 0, 0))
+        return {std::nullopt, m_depthSearched, nodes, nodesPerSecond, score, {}};
+    if (result.pv.size() > 1)
+        m_ponderMove = result.pv[1];
+    return {result.bestMove, m_depthSearched, nodes, nodesPerSecond, score, result.pv};
 }
 
-void Engine::runTimer()
+std::vector<Engine::RootPosition> Engine::selectPonderRoots(
+    const PieceBitBoards& bitBoards, const std::vector<uint64_t>& zobristKeysHistory) const
 {
-    // Check in case it is modified elsewhere.
-    while (m_runSearch) {
-        if (m_timer.timeUp()) {
-            m_runSearch = false;
-            return;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::vector<RootPosition> roots = {{bitBoards, zobristKeysHistory}};
+
+    // Replies evaluated by previous searches are ranked by evaluation from the opponent's
+    // perspective, replies without table entry keep move generation order after them.
+    std::vector<std::pair<int, RootPosition>> replies;
+    for (auto move :
+         MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(m_ponderParent->bitBoards)) {
+        PieceBitBoards boards = m_ponderParent->bitBoards;
+        boards.applyMove(move);
+        if (boards.zobristKey == bitBoards.zobristKey)
+            continue;
+        auto entry = m_transpositionTable.getEntry(boards.zobristKey);
+        auto score = entry.has_value() ? -entry->evaluation : Evaluate::negativeInfinity;
+        auto history = m_ponderParent->zobristKeysHistory;
+        history.push_back(boards.zobristKey);
+        replies.push_back({score, {boards, std::move(history)}});
     }
-}
+    std::stable_sort(replies.begin(), replies.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
 
-Timer::Timer(std::chrono::milliseconds timeLimit)
-    : m_timeLimit(timeLimit), m_startTime(std::chrono::high_resolution_clock::now())
-{
+    auto numberOfRoots = std::min<size_t>(m_ponderReplies, m_searches.size());
+    for (size_t i = 0; i < replies.size() && roots.size() < numberOfRoots; i++)
+        roots.push_back(std::move(replies[i].second));
+    return roots;
 }
 
-bool Timer::timeUp() const
+void Engine::waitForPonderEnd()
 {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-               std::chrono::high_resolution_clock::now() - m_startTime) >= m_timeLimit;
+    while (m_timeManager.isPondering() && m_stopRequestTime < 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
 }
 
-void Timer::resetStartTime()
+uint64_t Engine::getCountNodes() const
 {
-    m_startTime = std::chrono::high_resolution_clock::now();
+    uint64_t nodes = 0;
+    for (const auto& search : m_searches)
+        nodes += search->getCountNodes();
+    return nodes;
 }
 
-} // namespace chessAi
\ No newline at end of file
+} // namespace chessAi
@@ -1,35 +1,101 @@
 #pragma once
 
 #include "Move.h"
+#include "Search.h"
+#include "TimeManager.h"
 #include "TranspositionTable.h"
 
-#include <map>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <thread>
 
 namespace chessAi
 {
 
-class Timer
+struct PieceBitBoards;
+
+/**
+ * Evaluation as reported to the user, in centipawns or in moves to mate.
+ */
+struct Score
 {
-public:
-    Timer(std::chrono::milliseconds timeLimit);
-    void resetStartTime();
-    bool timeUp() const;
+    enum class Type
+    {
+        Centipawns,
+        Mate
+    };
 
-private:
-    std::chrono::milliseconds m_timeLimit;
-    std::chrono::time_point<std::chrono::high_resolution_clock> m_startTime;
+    /**
+     * Mate scores are converted to number of moves to mate, negative if the side to move gets
+     * mated.
+     */
+    static Score fromEvaluation(int evaluation);
+
+    Type type;
+    int value;
 };
 
-struct PieceBitBoards;
+/**
+ * Info about completed iterative deepening depth of the main search thread, or about root search
+ * failing outside of the aspiration window. With MultiPV there is one info for each line.
+ */
+struct SearchInfo
+{
+    unsigned int depth;
+    int evaluation;
+    Score score;
+    // Exact, or lower/upper bound when search failed high/low.
+    TranspositionTable::TypeOfNode bound;
+    std::chrono::milliseconds time;
+    // Nodes searched by all threads.
+    uint64_t nodes;
+    // Line number with MultiPV, 1 is the best line.
+    unsigned int multiPv;
+    // Principal variation of the line, empty when search failed low.
+    std::vector<Move> pv;
+};
+
+/**
+ * Result of findBestMove.
+ */
+struct SearchResult
+{
+    // nullopt if there is no legal move.
+    std::optional<Move> move;
+    // Completed iterative deepening depth of the main thread, 0 for book moves.
+    unsigned int depth;
+    // Nodes searched by all threads, in negamax and quiescence search.
+    uint64_t nodes;
+    uint64_t nodesPerSecond;
+    // Score of the last completed depth.
+    Score score;
+    // Principal variation starting with the move, empty if there is no legal move.
+    std::vector<Move> pv;
+};
+
+/**
+ * How multiple search threads cooperate. With one thread both modes are the same single threaded
+ * search.
+ */
+enum class SearchMode
+{
+    // Threads search the same root independently and share the transposition table.
+    LazySmp,
+    // Nodes are split after the first move, idle threads steal remaining moves.
+    YoungBrothersWait
+};
 
 /**
- * Chess engine using negamax approach.
+ * Chess engine using negamax approach. Engine is meant to stay alive for the whole game, every
+ * search starts a new transposition table generation.
  *
  * Search uses:
  *      Alpha-Beta pruning with move ordering.
  *      Transposition tables (Zobrist hashing).
  *      Iterative deepening.
+ *      Parallel search, Lazy SMP or Young Brothers Wait (see SearchMode).
  *
  * Evaluation is done with Evaluate class.
  */
@@ -38,7 +104,8 @@ class Engine
 public:
     /**
      * Engine that terminates search at depth or time limit. Which ever is reached first.
-     * Preferably just leave depth limit to 100 and limit by time.
+     * Preferably just leave depth limit to 100 and limit by time. Time limit is fixed time per
+     * move, use setTimeControl for clock based time limits.
      */
     Engine(bool useBook, const std::chrono::milliseconds& timeLimit, unsigned int depthLimit = 100);
 
@@ -46,69 +113,174 @@ public:
      * @param zobristKeysHistory Used to detect 3 fold repetition.
      * @param movesHistory Used for book moves.
      *
-     * @return Best move and depth to which the search was done.
-     * Depth search is from iterative deepening.
+     * @return Best move, depth to which the search was done, nodes, nodes per second, score and
+     * principal variation.
      */
-    std::pair<std::optional<Move>, unsigned int> findBestMove(
+    SearchResult findBestMove(
         const PieceBitBoards& bitBoards, const std::vector<uint64_t>& zobristKeysHistory,
         const std::vector<Move>& movesHistory);
 
-private:
     /**
-     * Alpha-Beta pruning, alpha keeps best score current active color could achieve, beta keeps
-     * opponents.
-     *
-     * If search is canceled during the search, return positive or negative infinity evaluation.
+     * Number of search threads including the main thread, minimum is 1. Search threads are only
+     * recreated (with empty move ordering heuristics) when the number changes.
      */
-    int negamax(const PieceBitBoards& bitBoards, unsigned int depth, int alpha, int beta,
-                unsigned int numCheckExtensions, const std::vector<uint64_t>& zobristKeysHistory);
+    void setNumberOfThreads(unsigned int numberOfThreads);
+
+    void setSearchMode(SearchMode searchMode);
 
     /**
-     * Run iterative deepening, with ordered moves from previous search.
-     * Return best move and true if move is shortest mate.
-     *
-     * Because we order moves, best move from previous search is searched first. In that case we can
-     * update best move even if search for this iteration depth was not completed fully. Current
-     * move is better than previous best move.
+     * Clear transposition table and move ordering heuristics, for a new game. Engine keeps them
+     * between searches, so search of the next move starts from the results of the previous one.
+     * Must not be called during search.
      */
-    std::pair<Move, bool> iterativeDeepening(const PieceBitBoards& bitBoards, unsigned int depth,
-                                             const std::vector<uint64_t>& zobristKeysHistory);
+    void clear();
 
     /**
-     * Order from best to worst. We can (hopefully) prune more
-     * branches if moves are order from best to worst in negamax.
-     *
-     * @param useTranspositions Set to false to not use transpositions.
-     *
-     * Checks for Most Valuable Victim - Least Valuable Aggressor, pawn promotion. (Moving to pawn
-     * guarded square currently disabled because of performance test.)
+     * Number of best lines reported at each depth, 1 by default. Lines are reported by info
+     * callback, findBestMove returns the move of the first line.
      */
-    [[nodiscard]] std::multimap<int, Move, std::greater<int>> orderMoves(
-        const std::vector<Move>& moves, const PieceBitBoards& boards,
-        bool useTranspositions = true);
+    void setMultiPv(unsigned int multiPv);
 
-    int evaluateEndGameType(const PieceBitBoards& boards, int depth,
-                            unsigned int numCheckExtensions);
+    /**
+     * Replaces time limit given in constructor. With ponder set, next search runs without time
+     * limits until ponderHit or stopSearch is called.
+     */
+    void setTimeControl(const TimeControl& timeControl);
+
+    /**
+     * Time subtracted from available time for each move, for communication and GUI lag.
+     */
+    void setMoveOverhead(std::chrono::milliseconds moveOverhead);
 
     /**
-     * Search position until quite and then return evaluation. Depth is the limit of captures
-     * search.
+     * Scale soft time limit with best move stability, root nodes of the best move and score trend
+     * (enabled by default).
      */
-    int quiescenceSearch(const PieceBitBoards& bitBoards, int alpha, int beta, int depth = 20);
+    void setAdaptiveTimeManagement(bool adaptive);
 
-    void runTimer();
+    /**
+     * Book moves are played only if the engine was constructed with the book and it was loaded.
+     * Book is keyed on moves history from the start position, so it must be disabled for searches
+     * from other positions.
+     */
+    void setUseOpeningBook(bool useBook);
+
+    /**
+     * ProbCut pruning at high depths (enabled by default), can be disabled for A/B testing.
+     */
+    void setProbCut(bool probCut);
+
+    /**
+     * Called from the search thread after each completed depth.
+     */
+    void setInfoCallback(std::function<void(const SearchInfo&)> infoCallback);
+
+    /**
+     * Can be called from another thread, findBestMove returns best move found so far. Stop
+     * requested before findBestMove starts stops the next search right away.
+     */
+    void stopSearch();
+
+    /**
+     * Clear stop request of a previous search. Must be called by the thread that sends stop
+     * before it starts the search thread, findBestMove never clears a pending stop, so stop sent
+     * right after go is not lost. Engine is ready after construction and after each search.
+     */
+    void prepareSearch();
+
+    /**
+     * Speculative pondering, ponder threads are split across numberOfReplies best replies of the
+     * opponent in the position before the expected reply (1 disables it). Only with Lazy SMP
+     * and more than one thread.
+     */
+    void setPonderReplies(unsigned int numberOfReplies);
+
+    /**
+     * Position before the expected reply, used by the next ponder search for speculative
+     * pondering. Cleared when the search ends.
+     */
+    void setPonderParent(const PieceBitBoards& bitBoards,
+                         const std::vector<uint64_t>& zobristKeysHistory);
+
+    /**
+     * Set depth limit of the next search.
+     */
+    void setDepthLimit(unsigned int depthLimit);
+
+    /**
+     * Node limit of the next searches, nullopt (default) disables it. Node limited search runs on
+     * the main thread only and is deterministic: it stops at the same node and returns the same
+     * move on every machine, with any number of threads.
+     */
+    void setNodeLimit(std::optional<uint64_t> nodeLimit);
+
+    /**
+     * Opponent played the expected move. Can be called from another thread, pondering search
+     * continues as a normal timed search, with limits counted from the start of pondering.
+     * Threads pondering other replies join the search of the expected reply.
+     */
+    void ponderHit();
+
+    /**
+     * Expected reply to the best move of the last search (second move of the principal
+     * variation), nullopt if the variation has only one move.
+     */
+    std::optional<Move> getPonderMove() const;
+
+    /**
+     * Time from stop request or hard time limit to the end of the last search, nullopt if search
+     * ended by itself (depth limit or shortest mate).
+     */
+    std::optional<std::chrono::microseconds> getStopLatency() const;
+
+private:
+    struct RootPosition
+    {
+        PieceBitBoards bitBoards;
+        std::vector<uint64_t> zobristKeysHistory;
+    };
+
+    uint64_t getCountNodes() const;
+
+    /**
+     * Root positions of speculative pondering, expected reply position is first. Other replies of
+     * the ponder parent are ranked by their transposition table evaluation from previous
+     * searches.
+     */
+    std::vector<RootPosition> selectPonderRoots(const PieceBitBoards& bitBoards,
+                                                const std::vector<uint64_t>& zobristKeysHistory)
+        const;
+
+    /**
+     * Best move must not be reported while pondering, wait for ponderhit or stop.
+     */
+    void waitForPonderEnd();
 
 private:
+    bool m_openingBookLoaded;
     bool m_useOpeningBook;
     TranspositionTable m_transpositionTable;
     unsigned int m_depthLimit;
-    unsigned int m_currentIterativeDepth;
+    std::optional<uint64_t> m_nodeLimit;
     unsigned int m_depthSearched;
-    unsigned int m_countTranspositions;
-    unsigned int m_countMaxCheckExtensions;
-    Timer m_timer;
-    std::thread m_timerThread;
+    unsigned int m_multiPv;
+    bool m_probCut;
+    TimeControl m_timeControl;
+    TimeManager m_timeManager;
     std::atomic<bool> m_runSearch;
+    // Elapsed time in microseconds when stop was first requested, negative if not requested.
+    std::atomic<int64_t> m_stopRequestTime;
+    std::optional<std::chrono::microseconds> m_stopLatency;
+    std::optional<Move> m_ponderMove;
+    unsigned int m_ponderReplies;
+    std::optional<RootPosition> m_ponderParent;
+    // Root index of each search thread during speculative pondering, 0 is the expected reply.
+    std::vector<size_t> m_ponderRootIndices;
+    std::atomic<bool> m_speculativePonder;
+    // First search is run by the main thread, others by helper threads.
+    std::vector<std::unique_ptr<Search>> m_searches;
+    SearchMode m_searchMode;
+    std::function<void(const SearchInfo&)> m_infoCallback;
 };
 
-} // namespace chessAi
\ No newline at end of file
+} // namespace chessAi
@@ -1,4 +1,5 @@
 #include "Evaluate.h"
+#include "MoveGenerator.h"
 
 #include <algorithm>
 
@@ -148,6 +149,90 @@ int Evaluate::getFigureValue(PieceFigure figure)
     }
 }
 
+int Evaluate::staticExchangeEvaluation(const PieceBitBoards& boards, Move move)
+{
+    // King can only capture last, capturing it ends the exchange.
+    constexpr int kingValue = 20000;
+    auto seeValue = [](PieceFigure figure) {
+        return figure == PieceFigure::King ? kingValue : getFigureValue(figure);
+    };
+
+    auto attacker = boards.getPieceTypeWithSetBitAtPosition(move.origin).getPieceFigure();
+    auto victim = boards.getPieceTypeWithSetBitAtPosition(move.destination).getPieceFigure();
+
+    uint64_t occupied = boards.getAllPiecesBoard();
+    PieceBitBoards::clearBit(occupied, move.origin);
+    // En passant captured pawn is behind destination.
+    if (move.specialMoveFlag == 2) {
+        victim = PieceFigure::Pawn;
+        PieceBitBoards::clearBit(occupied, (boards.currentMoveColor == PieceColor::White)
+                                               ? move.destination + 8
+                                               : move.destination - 8);
+    }
+
+    // Gain of each capture in the sequence, from the perspective of the side making it.
+    std::array<int, 32> gain{};
+    gain[0] = getFigureValue(victim);
+    auto attackerValue = seeValue(attacker);
+    if (move.specialMoveFlag == 1) {
+        constexpr std::array<PieceFigure, 4> promotionFigures = {
+            PieceFigure::Knight, PieceFigure::Bishop, PieceFigure::Rook, PieceFigure::Queen};
+        auto promotionFigure = promotionFigures[move.promotion];
+        gain[0] += getFigureValue(promotionFigure) - s_pawnValue;
+        attackerValue = getFigureValue(promotionFigure);
+    }
+
+    uint64_t attackers =
+        MoveGeneratorWrapper::attackersTo(boards, move.destination, occupied) & occupied;
+
+    auto color = PieceType::getOppositeColor(boards.currentMoveColor);
+    size_t depth = 0;
+    while (depth + 1 < gain.size()) {
+        // Least valuable attacker of the side to capture.
+        const std::array<std::pair<PieceFigure, uint64_t>, 6> figures =
+            (color == PieceColor::White)
+                ? std::array<std::pair<PieceFigure, uint64_t>, 6>{{
+                      {PieceFigure::Pawn, boards.whitePawns},
+                      {PieceFigure::Knight, boards.whiteKnights},
+                      {PieceFigure::Bishop, boards.whiteBishops},
+                      {PieceFigure::Rook, boards.whiteRooks},
+                      {PieceFigure::Queen, boards.whiteQueens},
+                      {PieceFigure::King, boards.whiteKing}}}
+                : std::array<std::pair<PieceFigure, uint64_t>, 6>{{
+                      {PieceFigure::Pawn, boards.blackPawns},
+                      {PieceFigure::Knight, boards.blackKnights},
+                      {PieceFigure::Bishop, boards.blackBishops},
+                      {PieceFigure::Rook, boards.blackRooks},
+                      {PieceFigure::Queen, boards.blackQueens},
+                      {PieceFigure::King, boards.blackKing}}};
+        auto figureIt = std::find_if(figures.begin(), figures.end(), [attackers](const auto& f) {
+            return (f.second & attackers) != 0;
+        });
+        if (figureIt == figures.end())
+            break;
+
+        depth++;
+        gain[depth] = attackerValue - gain[depth - 1];
+
+        auto attackerBoard = figureIt->second & attackers;
+        occupied &= ~(attackerBoard & (~attackerBoard + 1));
+        attackerValue = seeValue(figureIt->first);
+
+        // Sliding pieces behind the piece that captured now attack through it (x-ray).
+        attackers =
+            MoveGeneratorWrapper::attackersTo(boards, move.destination, occupied) & occupied;
+
+        color = PieceType::getOppositeColor(color);
+    }
+
+    // Each side chooses between stopping the exchange and continuing it.
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
+
 int Evaluate::kingPawnShield(const PieceBitBoards& boards)
 {
     int evaluation = 0;
@@ -12,6 +12,8 @@ public:
     inline static constexpr int negativeInfinity = -infinity;
     inline static constexpr int mateScore = infinity / 10;
     inline static constexpr int negativeMateScore = -mateScore;
+    // Evaluations at least this big (in absolute value) are mate scores, offset by plies to mate.
+    inline static constexpr int mateThreshold = mateScore - 1000;
 
 public:
     /**
@@ -22,6 +24,14 @@ public:
 
     static int getFigureValue(PieceFigure figure);
 
+    /**
+     * Static exchange evaluation, material gain of the side to move after all captures on
+     * destination of the move, with the least valuable attacker capturing first. Sides can stop
+     * capturing when it would lose material. Quiet moves evaluate if moved piece can be won.
+     * https://www.chessprogramming.org/Static_Exchange_Evaluation
+     */
+    static int staticExchangeEvaluation(const PieceBitBoards& boards, Move move);
+
 private:
     static float endgameWeight(const PieceBitBoards& boards);
     static int pieceSquareTableEvaluation(const PieceBitBoards& boards);
@@ -31,7 +41,8 @@ private:
     static std::array<std::array<int, 64>, 64> precalculateManhattanDistance();
 
 private:
-    inline static float s_endgameWeight = 0.f;
+    // Set for each evaluated position, search threads evaluate positions at the same time.
+    inline static thread_local float s_endgameWeight = 0.f;
 
     inline static const int s_pawnValue = 100;
     inline static const int s_bishopValue = 300;
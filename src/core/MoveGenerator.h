@@ -25,6 +25,13 @@ class MoveGeneratorWrapper
 public:
     template <MoveType TMoveType>
     static std::vector<Move> generateLegalMoves(const PieceBitBoards& bitBoards);
+
+    /**
+     * Pieces of both colors that attack square. Sliding piece attacks are generated with occupied
+     * board, so removing a piece from it discovers x-ray attackers behind it.
+     */
+    inline static uint64_t attackersTo(const PieceBitBoards& bitBoards, uint16_t square,
+                                       uint64_t occupied);
 };
 
 template <PieceColor TColor>
@@ -86,17 +93,14 @@ private:
      */
     inline static void appendMoveIfNoCheckHappens(std::vector<Move>& moves, Move move,
                                                   const PieceBitBoards& bitBoards);
-
-private:
-    inline static std::unique_ptr<magic_bits::Attacks> magicAttacks = nullptr;
 };
 
 template <PieceColor TColor>
 const std::unique_ptr<magic_bits::Attacks>& MoveGenerator<TColor>::getMagicAttacks()
 {
-    if (magicAttacks != nullptr)
-        return magicAttacks;
-    magicAttacks = std::make_unique<magic_bits::Attacks>();
+    // Initialization of function local static is thread safe, moves are generated by multiple
+    // search threads.
+    static const auto magicAttacks = std::make_unique<magic_bits::Attacks>();
     return magicAttacks;
 }
 
@@ -509,4 +513,23 @@ std::vector<Move> MoveGeneratorWrapper::generateLegalMoves(const PieceBitBoards&
     return moves;
 }
 
+uint64_t MoveGeneratorWrapper::attackersTo(const PieceBitBoards& bitBoards, uint16_t square,
+                                           uint64_t occupied)
+{
+    const auto& magicAttacks = MoveGenerator<PieceColor::White>::getMagicAttacks();
+    auto bishopAttacks = magicAttacks->Bishop(occupied, static_cast<int>(square));
+    auto rookAttacks = magicAttacks->Rook(occupied, static_cast<int>(square));
+
+    // Pawn attacks are not symmetrical, white pawns attack square from squares black pawn on the
+    // square would attack.
+    return (Pawn<PieceColor::Black>::originToAttacks[square] & bitBoards.whitePawns) |
+           (Pawn<PieceColor::White>::originToAttacks[square] & bitBoards.blackPawns) |
+           (Knight::originToAttacks[square] & (bitBoards.whiteKnights | bitBoards.blackKnights)) |
+           (King::originToAttacks[square] & (bitBoards.whiteKing | bitBoards.blackKing)) |
+           (bishopAttacks & (bitBoards.whiteBishops | bitBoards.blackBishops |
+                             bitBoards.whiteQueens | bitBoards.blackQueens)) |
+           (rookAttacks & (bitBoards.whiteRooks | bitBoards.blackRooks | bitBoards.whiteQueens |
+                           bitBoards.blackQueens));
+}
+
 } // namespace chessAi
\ No newline at end of file
@@ -398,6 +398,31 @@ void PieceBitBoards::applyMove(Move move)
     halfMoveCount++;
 }
 
+uint16_t PieceBitBoards::makeNullMove()
+{
+    auto previousEnPassantTargetSquare = enPassantTargetSquare;
+    if (enPassantTargetSquare != 0) {
+        zobristKey ^= ZobristHash::getEnPassantFile()[enPassantTargetSquare % 8];
+        enPassantTargetSquare = 0;
+    }
+
+    currentMoveColor = PieceType::getOppositeColor(currentMoveColor);
+    zobristKey ^= ZobristHash::getSideToMove();
+    halfMoveCount++;
+    return previousEnPassantTargetSquare;
+}
+
+void PieceBitBoards::unmakeNullMove(uint16_t previousEnPassantTargetSquare)
+{
+    enPassantTargetSquare = previousEnPassantTargetSquare;
+    if (enPassantTargetSquare != 0)
+        zobristKey ^= ZobristHash::getEnPassantFile()[enPassantTargetSquare % 8];
+
+    currentMoveColor = PieceType::getOppositeColor(currentMoveColor);
+    zobristKey ^= ZobristHash::getSideToMove();
+    halfMoveCount--;
+}
+
 void PieceBitBoards::handleCastling(PieceFigure figure, Move move)
 {
     // If king moves, castling privilege is lost.
@@ -70,6 +70,24 @@ public:
      */
     void applyMove(Move move);
 
+    /**
+     * Pass the move to the opponent (null move), clears en passant target square and updates
+     * zobrist key.
+     *
+     * @return En passant target square before the null move, pass it to unmakeNullMove.
+     */
+    uint16_t makeNullMove();
+
+    /**
+     * Undo null move made by makeNullMove.
+     */
+    void unmakeNullMove(uint16_t previousEnPassantTargetSquare);
+
+    /**
+     * True if color has any piece other than pawns and king.
+     */
+    inline bool hasNonPawnMaterial(PieceColor color) const;
+
     inline std::map<PieceType, const uint64_t*> getTypeToPieceBitBoards() const;
 
     inline static void setBit(uint64_t& number, uint16_t index);
@@ -157,6 +175,13 @@ inline uint16_t PieceBitBoards::countSetBits(uint64_t number)
     return count;
 }
 
+inline bool PieceBitBoards::hasNonPawnMaterial(PieceColor color) const
+{
+    if (color == PieceColor::White)
+        return (whiteBishops | whiteKnights | whiteRooks | whiteQueens) != 0;
+    return (blackBishops | blackKnights | blackRooks | blackQueens) != 0;
+}
+
 inline std::map<PieceType, const uint64_t*> PieceBitBoards::getTypeToPieceBitBoards() const
 {
     return {
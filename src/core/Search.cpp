@@ -0,0 +1,1426 @@
+#include "Search.h"
+#include "Evaluate.h"
+#include "MoveGenerator.h"
+#include "PieceBitBoards.h"
+#include "TimeManager.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace chessAi
+{
+
+namespace
+{
+
+// Lazy SMP depth skipping pattern for helper threads (as in Stockfish 9).
+constexpr std::array<unsigned int, 20> s_skipSize = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                                     3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+constexpr std::array<unsigned int, 20> s_skipPhase = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                                                      4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+std::array<std::array<unsigned int, 64>, 64> calculateLateMoveReductions()
+{
+    std::array<std::array<unsigned int, 64>, 64> reductions{};
+    for (size_t depth = 1; depth < 64; depth++) {
+        for (size_t moveNumber = 1; moveNumber < 64; moveNumber++) {
+            reductions[depth][moveNumber] = static_cast<unsigned int>(
+                0.75 + std::log(static_cast<double>(depth)) *
+                           std::log(static_cast<double>(moveNumber)) / 2.25);
+        }
+    }
+    return reductions;
+}
+
+// Late move reductions indexed by depth and move number, reduction grows with logarithm of both.
+const std::array<std::array<unsigned int, 64>, 64> s_lateMoveReductions =
+    calculateLateMoveReductions();
+
+// Most Valuable Victim - Least Valuable Aggressor score indexed by victim and attacker figure.
+std::array<std::array<int, 7>, 7> calculateMvvLva()
+{
+    std::array<std::array<int, 7>, 7> mvvLva{};
+    for (size_t victim = 0; victim < 7; victim++) {
+        for (size_t attacker = 0; attacker < 7; attacker++)
+            mvvLva[victim][attacker] = Evaluate::getFigureValue(static_cast<PieceFigure>(victim)) -
+                                       Evaluate::getFigureValue(static_cast<PieceFigure>(attacker));
+    }
+    return mvvLva;
+}
+
+const std::array<std::array<int, 7>, 7> s_mvvLva = calculateMvvLva();
+
+void scorePromotion(Move move, int& moveScore)
+{
+    if (move.specialMoveFlag == 1) {
+        if (move.promotion == 0)
+            moveScore += Evaluate::getFigureValue(PieceFigure::Knight);
+        if (move.promotion == 1)
+            moveScore += Evaluate::getFigureValue(PieceFigure::Bishop);
+        if (move.promotion == 2)
+            moveScore += Evaluate::getFigureValue(PieceFigure::Rook);
+        if (move.promotion == 3)
+            moveScore += Evaluate::getFigureValue(PieceFigure::Queen);
+    }
+}
+
+/**
+ * Selection sort step, swap best scored move from index on to index. Moves are sorted lazily, so
+ * no work is done for moves after a beta cutoff.
+ */
+void pickNextMove(std::vector<Move>& moves, Search::MoveScores& scores, size_t index)
+{
+    auto bestIndex = index;
+    for (auto i = index + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[bestIndex])
+            bestIndex = i;
+    }
+    if (bestIndex != index) {
+        std::swap(moves[index], moves[bestIndex]);
+        std::swap(scores[index], scores[bestIndex]);
+    }
+}
+
+/**
+ * Mate scores are stored in transposition table as distance to mate from the node, not from the
+ * root, so they stay correct when the position is reached at a different ply.
+ */
+int evaluationToTable(int evaluation, unsigned int ply)
+{
+    if (evaluation >= Evaluate::mateThreshold)
+        return evaluation + static_cast<int>(ply);
+    if (evaluation <= -Evaluate::mateThreshold)
+        return evaluation - static_cast<int>(ply);
+    return evaluation;
+}
+
+int evaluationFromTable(int evaluation, unsigned int ply)
+{
+    if (evaluation >= Evaluate::mateThreshold)
+        return evaluation - static_cast<int>(ply);
+    if (evaluation <= -Evaluate::mateThreshold)
+        return evaluation + static_cast<int>(ply);
+    return evaluation;
+}
+
+bool isQuietMove(const PieceBitBoards& bitBoards, Move move)
+{
+    // Promotion or en passant.
+    if (move.specialMoveFlag == 1 || move.specialMoveFlag == 2)
+        return false;
+    return !PieceBitBoards::getBit(bitBoards.getAllPiecesBoard(), move.destination);
+}
+
+} // namespace
+
+Search::Search(TranspositionTable& transpositionTable, std::atomic<bool>& runSearch,
+               const TimeManager& timeManager, unsigned int threadIndex)
+    : m_transpositionTable(transpositionTable), m_runSearch(runSearch), m_timeManager(timeManager),
+      m_aborted(false), m_stopped(false), m_threadIndex(threadIndex), m_multiPv(1), m_probCut(true),
+      m_rootMoveEvaluations(), m_countTranspositions(0), m_countMaxCheckExtensions(0),
+      m_countInternalIterativeDeepening(0), m_countInternalIterativeReductions(0),
+      m_countSingularExtensions(0), m_countProbCutTries(0), m_countProbCuts(0), m_countCutoffs(0),
+      m_sumCutoffMoveNumbers(0), m_countNodes(0), m_nodeLimit(std::nullopt), m_threadPool(nullptr),
+      m_splitPoint(nullptr), m_zobristKeysHistory(nullptr),
+      m_searchStack(s_stackOffset + s_maxPly + 1), m_waitingStack(nullptr),
+      m_pvTable((s_maxPly + 1) * (s_maxPly + 2) / 2, Move(0, 0, 0, 0)), m_previousPv(), m_history(),
+      m_counterMoves(12 * 64, Move(0, 0, 0, 0)), m_captureHistory(), m_continuationHistory(12 * 64),
+      m_followUpHistory(12 * 64)
+{
+}
+
+Search::SplitPoint::SplitPoint(const SplitPoint* parent, const PieceBitBoards& bitBoards,
+                               const std::vector<uint64_t>& zobristKeysHistory,
+                               const SearchStack* stack, unsigned int depth, int alpha, int beta,
+                               bool pvNode, Move singularMove, unsigned int pendingMoves)
+    : parent(parent), bitBoards(bitBoards), zobristKeysHistory(zobristKeysHistory),
+      stack({*(stack - 1), *stack}), depth(depth), beta(beta), pvNode(pvNode),
+      singularMove(singularMove), alpha(alpha), cutoff(false), pendingMoves(pendingMoves), mutex(),
+      bestEvaluation(Evaluate::negativeInfinity), bestMove(0, 0, 0, 0), pv()
+{
+}
+
+bool Search::SplitPoint::isAborted() const
+{
+    for (auto splitPoint = this; splitPoint != nullptr; splitPoint = splitPoint->parent) {
+        if (splitPoint->cutoff)
+            return true;
+    }
+    return false;
+}
+
+void Search::countNode()
+{
+    // Only this thread writes the counter, no need for atomic increment.
+    auto nodes = m_countNodes.load(std::memory_order_relaxed) + 1;
+    m_countNodes.store(nodes, std::memory_order_relaxed);
+    if (m_nodeLimit.has_value() && nodes >= *m_nodeLimit) {
+        m_runSearch = false;
+        m_stopped = true;
+        return;
+    }
+    if (nodes % s_timeCheckNodes == 0) {
+        if (m_timeManager.hardLimitReached())
+            m_runSearch = false;
+        m_stopped = !isRunning();
+    }
+}
+
+bool Search::isRunning() const
+{
+    return m_runSearch && !m_aborted;
+}
+
+void Search::abort()
+{
+    m_aborted = true;
+}
+
+void Search::clearAbort()
+{
+    m_aborted = false;
+}
+
+void Search::resetStatistics()
+{
+    m_countTranspositions = 0;
+    m_countMaxCheckExtensions = 0;
+    m_countInternalIterativeDeepening = 0;
+    m_countInternalIterativeReductions = 0;
+    m_countSingularExtensions = 0;
+    m_countProbCutTries = 0;
+    m_countProbCuts = 0;
+    m_countCutoffs = 0;
+    m_sumCutoffMoveNumbers = 0;
+    m_countNodes.store(0, std::memory_order_relaxed);
+}
+
+bool Search::isSearchStopped() const
+{
+    return m_stopped || (m_splitPoint != nullptr && m_splitPoint->isAborted());
+}
+
+int Search::evaluateEndGameType(const PieceBitBoards& bitBoards, const SearchStack* stack)
+{
+    bool inCheck = (bitBoards.currentMoveColor == PieceColor::White)
+                       ? MoveGenerator<PieceColor::White>::isKingInCheck(bitBoards)
+                       : MoveGenerator<PieceColor::Black>::isKingInCheck(bitBoards);
+    // Must add ply so we find the shortest mate.
+    if (inCheck)
+        return Evaluate::negativeMateScore + static_cast<int>(stack->ply);
+    return 0;
+}
+
+Move* Search::getPv(const SearchStack* stack)
+{
+    // Rows before the row of ply p have s_maxPly + 1, s_maxPly, ... s_maxPly + 2 - p moves.
+    size_t ply = stack->ply;
+    return &m_pvTable[ply * (2 * s_maxPly + 3 - ply) / 2];
+}
+
+void Search::updatePv(SearchStack* stack, Move move)
+{
+    auto pv = getPv(stack);
+    auto child = stack + 1;
+    pv[0] = move;
+    std::copy(getPv(child), getPv(child) + child->pvLength, pv + 1);
+    stack->pvLength = child->pvLength + 1;
+}
+
+void Search::extendPvFromTable(const PieceBitBoards& bitBoards, std::vector<Move>& pv) const
+{
+    PieceBitBoards boards = bitBoards;
+    std::vector<uint64_t> positions = {boards.zobristKey};
+    for (auto move : pv) {
+        boards.applyMove(move);
+        positions.push_back(boards.zobristKey);
+    }
+
+    while (pv.size() < s_maxPly) {
+        auto entry = m_transpositionTable.getEntry(boards.zobristKey);
+        if (!entry.has_value() || entry->bestMove == Move(0, 0, 0, 0))
+            return;
+        // Table entry could be from another position with the same index.
+        auto moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(boards);
+        if (std::find(moves.begin(), moves.end(), entry->bestMove) == moves.end())
+            return;
+        boards.applyMove(entry->bestMove);
+        // Repetition, table moves would cycle forever.
+        if (std::find(positions.begin(), positions.end(), boards.zobristKey) != positions.end())
+            return;
+        positions.push_back(boards.zobristKey);
+        pv.push_back(entry->bestMove);
+    }
+}
+
+int Search::quiescenceSearch(const PieceBitBoards& bitBoards, SearchStack* stack, int alpha,
+                             int beta)
+{
+    if (isSearchStopped())
+        return Evaluate::negativeInfinity;
+
+    countNode();
+
+    // Quiescence search results are stored with depth 0, every entry is deep enough.
+    auto tableEval = m_transpositionTable.getEntry(bitBoards.zobristKey);
+    if (tableEval.has_value()) {
+        auto tableEvaluation = evaluationFromTable(tableEval->evaluation, stack->ply);
+        if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::exact)
+            return std::clamp(tableEvaluation, alpha, beta);
+        if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::lower &&
+            tableEvaluation >= beta)
+            return beta;
+        if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::upper &&
+            tableEvaluation <= alpha)
+            return alpha;
+    }
+    // Do not overwrite deeper negamax entry of the same position.
+    bool storeInTable = !tableEval.has_value() || tableEval->depth == 0;
+
+    auto evaluation = Evaluate::getEvaluation(bitBoards);
+
+    if (stack->ply >= s_maxPly)
+        return evaluation;
+
+    // Stand pat, side to move doesn't have to capture.
+    if (evaluation >= beta) {
+        if (storeInTable)
+            m_transpositionTable.store(bitBoards.zobristKey, evaluationToTable(beta, stack->ply), 0,
+                                       TranspositionTable::TypeOfNode::lower, Move(0, 0, 0, 0));
+        return beta;
+    }
+
+    // Delta pruning, even capturing a queen can't raise evaluation to alpha. Not if a pawn can
+    // promote.
+    uint64_t promotingPawns = (bitBoards.currentMoveColor == PieceColor::White)
+                                  ? bitBoards.whitePawns & s_whitePromotionRank
+                                  : bitBoards.blackPawns & s_blackPromotionRank;
+    if (promotingPawns == 0 &&
+        evaluation + Evaluate::getFigureValue(PieceFigure::Queen) + s_deltaMargin < alpha)
+        return alpha;
+
+    int standPat = evaluation;
+    int previousAlpha = alpha;
+    alpha = std::max(evaluation, alpha);
+    Move bestMove(0, 0, 0, 0);
+
+    PieceBitBoards tempBoards = bitBoards;
+    auto moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Capture>(bitBoards);
+    MoveScores scores;
+    scoreMoves(moves, bitBoards, stack, scores);
+    for (size_t i = 0; i < moves.size(); i++) {
+        pickNextMove(moves, scores, i);
+        // Captures losing material by static exchange evaluation are ordered last and pruned.
+        if (scores[i] < s_badCaptureScore)
+            break;
+        auto move = moves[i];
+
+        // Delta pruning of a single capture, captured piece is not enough to raise alpha.
+        auto capturedPiece = (move.specialMoveFlag == 2)
+                                 ? PieceFigure::Pawn
+                                 : bitBoards.getPieceTypeWithSetBitAtPosition(move.destination)
+                                       .getPieceFigure();
+        if (move.specialMoveFlag != 1 &&
+            standPat + Evaluate::getFigureValue(capturedPiece) + s_deltaMargin <= alpha)
+            continue;
+
+        tempBoards.applyMove(move);
+        (stack + 1)->ply = stack->ply + 1;
+        evaluation = -quiescenceSearch(tempBoards, stack + 1, -beta, -alpha);
+        tempBoards = bitBoards;
+
+        if (isSearchStopped())
+            return Evaluate::negativeInfinity;
+
+        if (evaluation >= beta) {
+            if (storeInTable)
+                m_transpositionTable.store(bitBoards.zobristKey,
+                                           evaluationToTable(beta, stack->ply), 0,
+                                           TranspositionTable::TypeOfNode::lower, move);
+            return beta;
+        }
+        if (evaluation > alpha) {
+            alpha = evaluation;
+            bestMove = move;
+        }
+    }
+
+    if (storeInTable) {
+        auto typeOfNode = (alpha > previousAlpha) ? TranspositionTable::TypeOfNode::exact
+                                                  : TranspositionTable::TypeOfNode::upper;
+        m_transpositionTable.store(bitBoards.zobristKey, evaluationToTable(alpha, stack->ply), 0,
+                                   typeOfNode, bestMove);
+    }
+    return alpha;
+}
+
+int Search::negamax(const PieceBitBoards& bitBoards, SearchStack* stack, unsigned int depth,
+                    int alpha, int beta, bool pvNode, bool allowNullMove)
+{
+    // Nodes returning before the move loop have no principal variation.
+    stack->pvLength = 0;
+    if (isSearchStopped())
+        return Evaluate::negativeInfinity;
+
+    countNode();
+
+    // Mate distance pruning, we can't mate faster than in the next move or be mated faster than
+    // now. If a shorter mate was already found, this node can't improve it.
+    alpha = std::max(alpha, Evaluate::negativeMateScore + static_cast<int>(stack->ply));
+    beta = std::min(beta, Evaluate::mateScore - static_cast<int>(stack->ply) - 1);
+    if (alpha >= beta)
+        return alpha;
+
+    int previousAlpha = alpha;
+
+    // Singular extension search of this node excludes the transposition table move. Its result
+    // is not the result of the full node, so it is not cut off by or stored to the table.
+    auto excludedMove = stack->excludedMove;
+    bool excludedSearch = !(excludedMove == Move(0, 0, 0, 0));
+
+    auto tableEval = m_transpositionTable.getEntry(bitBoards.zobristKey);
+    int tableEvaluation = 0;
+
+    if (!excludedSearch && tableEval.has_value() && tableEval->depth >= depth) {
+        m_countTranspositions++;
+        tableEvaluation = evaluationFromTable(tableEval->evaluation, stack->ply);
+        if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::exact) {
+            return tableEvaluation;
+        }
+        else if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::lower) {
+            alpha = std::max(alpha, tableEvaluation);
+        }
+        else if (tableEval->typeOfNode == TranspositionTable::TypeOfNode::upper) {
+            beta = std::min(beta, tableEvaluation);
+        }
+        else
+            CHESS_LOG_ERROR("Evaluation in table with node type none.");
+    }
+
+    if (alpha >= beta)
+        return tableEvaluation;
+
+    // We pass alpha, beta and not -beta, -alpha because it is still our move. Nodes at maximum
+    // ply have no stack entry for children.
+    if (depth == 0 || stack->ply >= s_maxPly)
+        return quiescenceSearch(bitBoards, stack, alpha, beta);
+
+    PieceBitBoards tempBoards = bitBoards;
+    bool inCheck = (bitBoards.currentMoveColor == PieceColor::White)
+                       ? MoveGenerator<PieceColor::White>::isKingInCheck(bitBoards)
+                       : MoveGenerator<PieceColor::Black>::isKingInCheck(bitBoards);
+
+    // Forward pruning is driven by static evaluation, which is not reliable in check. PV nodes are
+    // not pruned, as well as nodes with mate scores in the window.
+    bool forwardPruning = !pvNode && !inCheck && !excludedSearch &&
+                          std::abs(alpha) < Evaluate::mateThreshold &&
+                          std::abs(beta) < Evaluate::mateThreshold;
+    stack->staticEvaluation = inCheck ? 0 : Evaluate::getEvaluation(bitBoards);
+    auto staticEvaluation = stack->staticEvaluation;
+    bool shallowPruning = forwardPruning && depth <= s_shallowPruningMaxDepth;
+
+    // Reverse futility pruning (static null move), position is so good that a move can't make it
+    // worse than beta.
+    if (shallowPruning && staticEvaluation - s_reverseFutilityMargins[depth] >= beta)
+        return staticEvaluation - s_reverseFutilityMargins[depth];
+
+    // Razoring, position is so bad that only captures could save it.
+    if (shallowPruning && staticEvaluation + s_razoringMargins[depth] < alpha) {
+        auto evaluation = quiescenceSearch(bitBoards, stack, alpha - 1, alpha);
+        if (depth == 1 || evaluation < alpha)
+            return evaluation;
+    }
+
+    // Null move pruning. If position is still good enough after passing the move to the opponent,
+    // a real move will (most likely) be too. Not valid in check and in pawn endgames, where
+    // zugzwang is common. Mate scores are not trusted, as they are not proven after a null move.
+    if (forwardPruning && allowNullMove && depth >= s_nullMoveMinDepth &&
+        bitBoards.hasNonPawnMaterial(bitBoards.currentMoveColor)) {
+        if (staticEvaluation >= beta) {
+            auto reduction =
+                2 + depth / 4 +
+                static_cast<unsigned int>(std::min((staticEvaluation - beta) / 200, 2));
+            auto nullMoveDepth = (depth > reduction + 1) ? depth - reduction - 1 : 0;
+
+            auto enPassantTargetSquare = tempBoards.makeNullMove();
+            stack->currentMove = Move(0, 0, 0, 0);
+            stack->movedPiece = s_noPiece;
+            auto child = stack + 1;
+            child->ply = stack->ply + 1;
+            child->numExtensions = stack->numExtensions;
+            child->followPv = false;
+            child->excludedMove = Move(0, 0, 0, 0);
+            int evaluation = -negamax(tempBoards, child, nullMoveDepth, -beta, -beta + 1, false,
+                                      false);
+            tempBoards.unmakeNullMove(enPassantTargetSquare);
+
+            if (isSearchStopped())
+                return Evaluate::negativeInfinity;
+            if (evaluation >= beta) {
+                evaluation = std::min(evaluation, Evaluate::mateThreshold - 1);
+                if (depth < s_nullMoveVerificationDepth)
+                    return evaluation;
+                // Verification search, catches zugzwang positions the null move missed.
+                int verification =
+                    negamax(bitBoards, stack, nullMoveDepth, beta - 1, beta, false, false);
+                if (verification >= beta)
+                    return evaluation;
+            }
+        }
+    }
+
+    // ProbCut, a capture beats beta by a margin even in reduced depth search.
+    if (forwardPruning && m_probCut && depth >= s_probCutMinDepth) {
+        auto evaluation = probCut(bitBoards, stack, depth, beta, tableEval);
+        if (isSearchStopped())
+            return Evaluate::negativeInfinity;
+        if (evaluation.has_value())
+            return beta;
+    }
+
+    // No transposition table move as deep as internal iterative deepening search would find, so
+    // the first move would be ordered only by static heuristics.
+    if (!excludedSearch && depth >= s_internalIterativeMinDepth &&
+        (!tableEval.has_value() || tableEval->bestMove == Move(0, 0, 0, 0) ||
+         tableEval->depth + s_internalIterativeReduction < depth)) {
+        if (pvNode) {
+            // Internal iterative deepening, reduced search stores best move in transposition
+            // table, which is then searched first.
+            m_countInternalIterativeDeepening++;
+            negamax(bitBoards, stack, depth - s_internalIterativeReduction, alpha, beta, true);
+            if (isSearchStopped())
+                return Evaluate::negativeInfinity;
+        }
+        else {
+            // Internal iterative reduction, node without a good first move is probably not
+            // important, search it one ply shallower.
+            m_countInternalIterativeReductions++;
+            depth--;
+        }
+    }
+
+    // Singular extension, if all moves except the transposition table move fail low on a reduced
+    // search with lowered beta, the table move is much better than the others and is extended.
+    // If they fail high and lowered beta is still above beta, more than one move causes a cutoff
+    // and the node is pruned (multi-cut).
+    Move singularMove(0, 0, 0, 0);
+    if (!excludedSearch && depth >= s_singularExtensionMinDepth &&
+        tableEval.has_value() && !(tableEval->bestMove == Move(0, 0, 0, 0)) &&
+        tableEval->typeOfNode != TranspositionTable::TypeOfNode::upper &&
+        tableEval->depth + s_singularExtensionDepthMargin >= depth &&
+        std::abs(tableEval->evaluation) < Evaluate::mateThreshold) {
+        int singularBeta =
+            tableEval->evaluation - s_singularExtensionMargin * static_cast<int>(depth);
+        stack->excludedMove = tableEval->bestMove;
+        auto evaluation =
+            negamax(bitBoards, stack, (depth - 1) / 2, singularBeta - 1, singularBeta, false);
+        stack->excludedMove = Move(0, 0, 0, 0);
+
+        if (isSearchStopped())
+            return Evaluate::negativeInfinity;
+        if (evaluation < singularBeta) {
+            singularMove = tableEval->bestMove;
+            m_countSingularExtensions++;
+        }
+        else if (singularBeta >= beta)
+            return singularBeta;
+    }
+
+    std::vector<Move> moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(bitBoards);
+
+    if (moves.empty())
+        return evaluateEndGameType(bitBoards, stack);
+
+    int bestEvaluation = Evaluate::negativeInfinity;
+    Move bestMove(0, 0, 0, 0);
+    // Searched moves that didn't cause a cutoff are swapped to the front of already picked moves,
+    // they get history malus without a list of their own.
+    unsigned int numFailedMoves = 0;
+
+    // Reduced searches of this node above may have set a principal variation.
+    stack->pvLength = 0;
+    MoveScores scores;
+    scoreMoves(moves, bitBoards, stack, scores);
+    for (unsigned int moveNumber = 0; moveNumber < moves.size(); moveNumber++) {
+        pickNextMove(moves, scores, moveNumber);
+        auto move = moves[moveNumber];
+        if (excludedSearch && move == excludedMove)
+            continue;
+        tempBoards.applyMove(move);
+        if (shallowPruning && moveNumber > 0 &&
+            isPrunableQuietMove(bitBoards, tempBoards, stack, move, depth, moveNumber, alpha)) {
+            tempBoards = bitBoards;
+            continue;
+        }
+        int evaluation = 0;
+        bool singularExtension = move == singularMove;
+        // Principal variation search. First move is expected to be the best, it is searched with
+        // full window. Other moves are searched with null window to prove they are worse, if not
+        // they are re-searched with full window. Late quiet moves are searched with reduced depth
+        // first, and re-searched with full depth if they beat alpha.
+        if (moveNumber == 0)
+            evaluation = searchChild(tempBoards, stack, move, depth, alpha, beta, pvNode, 0,
+                                     singularExtension);
+        else {
+            auto reduction =
+                lateMoveReduction(bitBoards, stack, move, depth, moveNumber, pvNode, inCheck);
+            evaluation = searchChild(tempBoards, stack, move, depth, alpha, alpha + 1, false,
+                                     reduction, singularExtension);
+            if (reduction > 0 && evaluation > alpha)
+                evaluation = searchChild(tempBoards, stack, move, depth, alpha, alpha + 1, false,
+                                         0, singularExtension);
+            if (pvNode && evaluation > alpha && evaluation < beta)
+                evaluation = searchChild(tempBoards, stack, move, depth, alpha, beta, true, 0,
+                                         singularExtension);
+        }
+        tempBoards = bitBoards;
+
+        if (evaluation > bestEvaluation) {
+            bestEvaluation = evaluation;
+            bestMove = move;
+            if (pvNode && evaluation > alpha)
+                updatePv(stack, move);
+            alpha = std::max(evaluation, alpha);
+        }
+
+        if (alpha >= beta) {
+            m_countCutoffs++;
+            m_sumCutoffMoveNumbers += moveNumber;
+            if (!isSearchStopped()) {
+                if (isQuietMove(bitBoards, move)) {
+                    updateQuietMoveHeuristics(bitBoards, stack, move, depth, moves,
+                                              numFailedMoves);
+                    updateCaptureHeuristics(bitBoards, nullptr, depth, moves, numFailedMoves);
+                }
+                else
+                    updateCaptureHeuristics(bitBoards, &move, depth, moves, numFailedMoves);
+            }
+            break;
+        }
+        std::swap(moves[numFailedMoves++], moves[moveNumber]);
+
+        // Young Brothers Wait, eldest brother is searched first, then younger brothers in
+        // parallel.
+        if (m_threadPool != nullptr && moveNumber == 0 && depth >= s_minSplitDepth &&
+            moves.size() > 1) {
+            std::vector<Move> youngerBrothers;
+            for (unsigned int i = 1; i < moves.size(); i++) {
+                pickNextMove(moves, scores, i);
+                if (excludedSearch && moves[i] == excludedMove)
+                    continue;
+                if (shallowPruning) {
+                    tempBoards.applyMove(moves[i]);
+                    bool prunable = isPrunableQuietMove(bitBoards, tempBoards, stack, moves[i],
+                                                        depth, i, alpha);
+                    tempBoards = bitBoards;
+                    if (prunable)
+                        continue;
+                }
+                youngerBrothers.push_back(moves[i]);
+            }
+            if (youngerBrothers.empty())
+                break;
+
+            auto [splitEvaluation, splitBestMove] =
+                searchSplitPoint(bitBoards, stack, youngerBrothers, depth, alpha, beta, pvNode,
+                                 inCheck, singularMove);
+            if (splitEvaluation > bestEvaluation) {
+                bestEvaluation = splitEvaluation;
+                bestMove = splitBestMove;
+            }
+            // Moves searched by other threads are unknown, so no history malus.
+            if (!isSearchStopped() && bestEvaluation >= beta) {
+                if (isQuietMove(bitBoards, bestMove))
+                    updateQuietMoveHeuristics(bitBoards, stack, bestMove, depth, moves, 0);
+                else
+                    updateCaptureHeuristics(bitBoards, &bestMove, depth, moves, 0);
+            }
+            break;
+        }
+    }
+
+    // All moves except the excluded one were pruned.
+    if (excludedSearch && bestMove == Move(0, 0, 0, 0))
+        return alpha;
+
+    // Only store if leaf nodes were reached.
+    if (!excludedSearch && !isSearchStopped() && !(bestMove == Move(0, 0, 0, 0))) {
+        auto nodeType = TranspositionTable::TypeOfNode::exact;
+        if (bestEvaluation <= previousAlpha)
+            nodeType = TranspositionTable::TypeOfNode::upper;
+        else if (bestEvaluation >= beta)
+            nodeType = TranspositionTable::TypeOfNode::lower;
+        m_transpositionTable.store(bitBoards.zobristKey,
+                                   evaluationToTable(bestEvaluation, stack->ply), depth, nodeType,
+                                   bestMove);
+    }
+    return bestEvaluation;
+}
+
+int Search::searchChild(const PieceBitBoards& tempBoards, SearchStack* stack, Move move,
+                        unsigned int depth, int alpha, int beta, bool pvNode,
+                        unsigned int reduction, bool singularExtension)
+{
+    auto child = stack + 1;
+    child->pvLength = 0;
+    // Detect 3 fold repetition.
+    if (std::count(m_zobristKeysHistory->begin(), m_zobristKeysHistory->end(),
+                   tempBoards.zobristKey) > 0)
+        return 0;
+
+    bool givesCheck = (tempBoards.currentMoveColor == PieceColor::White)
+                          ? MoveGenerator<PieceColor::White>::isKingInCheck(tempBoards)
+                          : MoveGenerator<PieceColor::Black>::isKingInCheck(tempBoards);
+    // Check and singular extensions, limit number of extensions to 10.
+    bool extension = (givesCheck || singularExtension) && stack->numExtensions <= 9;
+    m_countMaxCheckExtensions = std::max(stack->numExtensions, m_countMaxCheckExtensions);
+
+    auto childDepth = depth - 1 + extension;
+    // Reduced search never drops directly into quiescence search.
+    if (!givesCheck && reduction > 0 && childDepth > 1)
+        childDepth -= std::min(reduction, childDepth - 1);
+
+    stack->currentMove = move;
+    stack->movedPiece =
+        tempBoards.getPieceTypeWithSetBitAtPosition(move.destination).getPieceIndex();
+    child->ply = stack->ply + 1;
+    child->numExtensions = stack->numExtensions + extension;
+    // Entry can be left over from another node at this ply (split point of another thread).
+    child->excludedMove = Move(0, 0, 0, 0);
+    child->followPv = stack->followPv && stack->ply < m_previousPv.size() &&
+                      move == m_previousPv[stack->ply];
+    // Minus sign is needed because we evaluate the position from the perspective of current
+    // move color. Good for the opponent, bad for us.
+    return -negamax(tempBoards, child, childDepth, -beta, -alpha, pvNode);
+}
+
+std::optional<int> Search::probCut(const PieceBitBoards& bitBoards, SearchStack* stack,
+                                   unsigned int depth, int beta,
+                                   const std::optional<TranspositionTable::Entry>& tableEval)
+{
+    int probCutBeta = beta + s_probCutMargin;
+    auto verificationDepth = depth - s_probCutReduction;
+
+    // Search at least as deep as the verification already stayed below raised beta.
+    if (tableEval.has_value() && tableEval->depth >= verificationDepth &&
+        tableEval->typeOfNode != TranspositionTable::TypeOfNode::lower &&
+        evaluationFromTable(tableEval->evaluation, stack->ply) < probCutBeta)
+        return std::nullopt;
+
+    PieceBitBoards tempBoards = bitBoards;
+    auto moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Capture>(bitBoards);
+    MoveScores scores;
+    scoreMoves(moves, bitBoards, stack, scores);
+    for (size_t i = 0; i < moves.size(); i++) {
+        pickNextMove(moves, scores, i);
+        auto move = moves[i];
+        if (stack->staticEvaluation + Evaluate::staticExchangeEvaluation(bitBoards, move) <
+            probCutBeta)
+            continue;
+
+        m_countProbCutTries++;
+        tempBoards.applyMove(move);
+        stack->currentMove = move;
+        stack->movedPiece =
+            tempBoards.getPieceTypeWithSetBitAtPosition(move.destination).getPieceIndex();
+        auto child = stack + 1;
+        child->ply = stack->ply + 1;
+        child->pvLength = 0;
+        child->followPv = false;
+        // Quiescence search is cheap, only captures that pass it are verified by reduced search.
+        int evaluation = -quiescenceSearch(tempBoards, child, -probCutBeta, -probCutBeta + 1);
+        if (evaluation >= probCutBeta)
+            evaluation = searchChild(tempBoards, stack, move, verificationDepth + 1,
+                                     probCutBeta - 1, probCutBeta, false);
+        tempBoards = bitBoards;
+
+        if (isSearchStopped())
+            return std::nullopt;
+        if (evaluation >= probCutBeta) {
+            m_countProbCuts++;
+            m_transpositionTable.store(bitBoards.zobristKey,
+                                       evaluationToTable(evaluation, stack->ply),
+                                       verificationDepth + 1,
+                                       TranspositionTable::TypeOfNode::lower, move);
+            return evaluation;
+        }
+    }
+    return std::nullopt;
+}
+
+unsigned int Search::lateMoveReduction(const PieceBitBoards& bitBoards, const SearchStack* stack,
+                                       Move move, unsigned int depth, unsigned int moveNumber,
+                                       bool pvNode, bool inCheck) const
+{
+    if (inCheck || depth < s_lateMoveReductionMinDepth ||
+        moveNumber < s_lateMoveReductionMinMoveNumber || !isQuietMove(bitBoards, move))
+        return 0;
+
+    auto reduction = static_cast<int>(
+        s_lateMoveReductions[std::min(depth, 63u)][std::min(moveNumber, 63u)]);
+    // Principal variation is more important, reduce it less.
+    if (pvNode)
+        reduction--;
+    if (isKillerMove(stack, move))
+        reduction--;
+    // Moves with good history are reduced less, with bad history more.
+    reduction -= getHistory(bitBoards.currentMoveColor, move) / (s_maxHistory / 2);
+    return static_cast<unsigned int>(std::max(reduction, 0));
+}
+
+bool Search::isPrunableQuietMove(const PieceBitBoards& bitBoards, const PieceBitBoards& tempBoards,
+                                 const SearchStack* stack, Move move, unsigned int depth,
+                                 unsigned int moveNumber, int alpha) const
+{
+    if (!isQuietMove(bitBoards, move) || isKillerMove(stack, move))
+        return false;
+
+    // Futility pruning, quiet move can't raise static evaluation above alpha. Move count pruning,
+    // late quiet moves are unlikely to be better than moves searched before.
+    bool futile = stack->staticEvaluation + s_futilityMargins[depth] <= alpha;
+    bool late = moveNumber >= s_moveCountPruningLimits[depth];
+    if (!futile && !late)
+        return false;
+
+    bool givesCheck = (tempBoards.currentMoveColor == PieceColor::White)
+                          ? MoveGenerator<PieceColor::White>::isKingInCheck(tempBoards)
+                          : MoveGenerator<PieceColor::Black>::isKingInCheck(tempBoards);
+    return !givesCheck;
+}
+
+void Search::updateQuietMoveHeuristics(const PieceBitBoards& bitBoards, SearchStack* stack,
+                                       Move move, unsigned int depth,
+                                       const std::vector<Move>& failedMoves,
+                                       unsigned int numFailedMoves)
+{
+    if (!(stack->killerMoves[0] == move)) {
+        stack->killerMoves[1] = stack->killerMoves[0];
+        stack->killerMoves[0] = move;
+    }
+
+    auto previousMove = getMoveIndex(stack - 1);
+    if (previousMove.has_value())
+        m_counterMoves[*previousMove] = move;
+    auto followedMove = getMoveIndex(stack - 2);
+
+    auto bonus = static_cast<int>(std::min(depth * depth, 400u));
+    auto updateQuietMove = [&](Move quietMove, int quietBonus) {
+        auto color = static_cast<size_t>(bitBoards.currentMoveColor);
+        updateHistory(m_history[color][quietMove.origin][quietMove.destination], quietBonus);
+        auto piece = bitBoards.getPieceTypeWithSetBitAtPosition(quietMove.origin).getPieceIndex();
+        if (previousMove.has_value())
+            updateHistory(m_continuationHistory[*previousMove][piece][quietMove.destination],
+                          quietBonus);
+        if (followedMove.has_value())
+            updateHistory(m_followUpHistory[*followedMove][piece][quietMove.destination],
+                          quietBonus);
+    };
+    updateQuietMove(move, bonus);
+    for (unsigned int i = 0; i < numFailedMoves; i++) {
+        if (isQuietMove(bitBoards, failedMoves[i]))
+            updateQuietMove(failedMoves[i], -bonus);
+    }
+}
+
+void Search::updateCaptureHeuristics(const PieceBitBoards& bitBoards, const Move* move,
+                                     unsigned int depth, const std::vector<Move>& failedMoves,
+                                     unsigned int numFailedMoves)
+{
+    auto bonus = static_cast<int>(std::min(depth * depth, 400u));
+    auto updateCapture = [&](Move capture, int captureBonus) {
+        auto piece = bitBoards.getPieceTypeWithSetBitAtPosition(capture.origin).getPieceIndex();
+        auto capturedPiece = (capture.specialMoveFlag == 2)
+                                 ? PieceFigure::Pawn
+                                 : bitBoards.getPieceTypeWithSetBitAtPosition(capture.destination)
+                                       .getPieceFigure();
+        updateHistory(
+            m_captureHistory[piece][capture.destination][static_cast<size_t>(capturedPiece)],
+            captureBonus);
+    };
+    if (move != nullptr)
+        updateCapture(*move, bonus);
+    for (unsigned int i = 0; i < numFailedMoves; i++) {
+        if (!isQuietMove(bitBoards, failedMoves[i]))
+            updateCapture(failedMoves[i], -bonus);
+    }
+}
+
+void Search::updateHistory(int& history, int bonus)
+{
+    history += bonus - history * std::abs(bonus) / s_maxHistory;
+}
+
+int Search::getHistory(PieceColor color, Move move) const
+{
+    return m_history[static_cast<size_t>(color)][move.origin][move.destination];
+}
+
+int Search::getContinuationHistory(const PieceBitBoards& bitBoards, const SearchStack* stack,
+                                   Move move) const
+{
+    auto piece = bitBoards.getPieceTypeWithSetBitAtPosition(move.origin).getPieceIndex();
+    int history = 0;
+    if (auto previousMove = getMoveIndex(stack - 1); previousMove.has_value())
+        history += m_continuationHistory[*previousMove][piece][move.destination];
+    if (auto followedMove = getMoveIndex(stack - 2); followedMove.has_value())
+        history += m_followUpHistory[*followedMove][piece][move.destination];
+    return history;
+}
+
+int Search::getCaptureHistory(const PieceBitBoards& bitBoards, Move move) const
+{
+    auto piece = bitBoards.getPieceTypeWithSetBitAtPosition(move.origin).getPieceIndex();
+    auto capturedPiece = (move.specialMoveFlag == 2)
+                             ? PieceFigure::Pawn
+                             : bitBoards.getPieceTypeWithSetBitAtPosition(move.destination)
+                                   .getPieceFigure();
+    return m_captureHistory[piece][move.destination][static_cast<size_t>(capturedPiece)];
+}
+
+bool Search::isCounterMove(const SearchStack* stack, Move move) const
+{
+    auto previousMove = getMoveIndex(stack - 1);
+    return previousMove.has_value() && m_counterMoves[*previousMove] == move;
+}
+
+std::optional<size_t> Search::getMoveIndex(const SearchStack* stack)
+{
+    if (stack->movedPiece == s_noPiece)
+        return std::nullopt;
+    return stack->movedPiece * 64 + stack->currentMove.destination;
+}
+
+bool Search::isKillerMove(const SearchStack* stack, Move move)
+{
+    return stack->killerMoves[0] == move || stack->killerMoves[1] == move;
+}
+
+std::pair<int, Move> Search::searchSplitPoint(const PieceBitBoards& bitBoards,
+                                              SearchStack* stack,
+                                              const std::vector<Move>& moves, unsigned int depth,
+                                              int alpha, int beta, bool pvNode, bool inCheck,
+                                              Move singularMove)
+{
+    SplitPoint splitPoint(m_splitPoint, bitBoards, *m_zobristKeysHistory, stack, depth, alpha,
+                          beta, pvNode, singularMove, static_cast<unsigned int>(moves.size()));
+
+    // Pushed in reverse, so this thread pops moves in move ordering order and thieves steal the
+    // worst ordered moves.
+    // Younger brothers start with move number 1, eldest brother was searched before the split.
+    for (auto it = moves.rbegin(); it != moves.rend(); it++) {
+        auto moveNumber = static_cast<unsigned int>(std::distance(it, moves.rend()));
+        auto reduction =
+            lateMoveReduction(bitBoards, stack, *it, depth, moveNumber, pvNode, inCheck);
+        m_threadPool->push(m_threadIndex, [&splitPoint, move = *it, reduction](Search& search) {
+            search.searchSplitPointMove(splitPoint, move, reduction);
+        });
+    }
+
+    // Principal variation of the eldest brother is kept unless a younger brother raises alpha.
+    std::vector<Move> pv(getPv(stack), getPv(stack) + stack->pvLength);
+
+    // Help with any task until all moves of this split point are searched.
+    auto previousWaitingStack = m_waitingStack;
+    m_waitingStack = stack;
+    while (splitPoint.pendingMoves.load(std::memory_order_acquire) > 0) {
+        if (!m_threadPool->runPendingTask(m_threadIndex))
+            std::this_thread::yield();
+    }
+    m_waitingStack = previousWaitingStack;
+
+    std::lock_guard lock(splitPoint.mutex);
+    if (!splitPoint.pv.empty())
+        pv = splitPoint.pv;
+    std::copy(pv.begin(), pv.end(), getPv(stack));
+    stack->pvLength = static_cast<unsigned int>(pv.size());
+    return {splitPoint.bestEvaluation, splitPoint.bestMove};
+}
+
+void Search::searchSplitPointMove(SplitPoint& splitPoint, Move move, unsigned int reduction)
+{
+    if (isRunning() && !splitPoint.isAborted()) {
+        // Stop flag of a previous search may still be set on pool workers.
+        m_stopped = false;
+        auto previousSplitPoint = m_splitPoint;
+        auto previousZobristKeysHistory = m_zobristKeysHistory;
+        m_splitPoint = &splitPoint;
+        m_zobristKeysHistory = &splitPoint.zobristKeysHistory;
+
+        // Split node and its parent are copied to the same plies of this thread's stack. Entries
+        // from the parent ply on (up to the ply this thread waits at, if it waits at its own split
+        // point) are overwritten and restored after the move is searched, so split node entries
+        // (excluded move, killer moves) don't leak into later searches of this thread.
+        auto stack = &m_searchStack[s_stackOffset + splitPoint.stack[1].ply];
+        bool waitsBelow = m_waitingStack != nullptr && m_waitingStack > stack;
+        const SearchStack* parent = stack - 1;
+        std::vector<SearchStack> savedStack(parent, waitsBelow ? m_waitingStack + 1 : stack + 1);
+        *(stack - 1) = splitPoint.stack[0];
+        *stack = splitPoint.stack[1];
+        // Principal variations of this thread's nodes below the split node, down to the node it
+        // waits at, are in PV table rows that are overwritten by the search of the move. Row of
+        // the next ply follows the row of the split node.
+        Move* savedPvBegin = getPv(stack) + (s_maxPly + 1 - stack->ply);
+        std::vector<Move> savedPv(
+            savedPvBegin,
+            waitsBelow ? getPv(m_waitingStack) + (s_maxPly + 1 - m_waitingStack->ply)
+                       : savedPvBegin);
+        // Previous principal variation of this thread is of another search.
+        stack->followPv = false;
+
+        PieceBitBoards tempBoards = splitPoint.bitBoards;
+        tempBoards.applyMove(move);
+        // Younger brothers are never the first move, null window search as in negamax.
+        auto alpha = splitPoint.alpha.load(std::memory_order_relaxed);
+        bool singularExtension = move == splitPoint.singularMove;
+        int evaluation = searchChild(tempBoards, stack, move, splitPoint.depth, alpha, alpha + 1,
+                                     false, reduction, singularExtension);
+        if (reduction > 0 && evaluation > alpha)
+            evaluation = searchChild(tempBoards, stack, move, splitPoint.depth, alpha, alpha + 1,
+                                     false, 0, singularExtension);
+        if (splitPoint.pvNode && evaluation > alpha && evaluation < splitPoint.beta)
+            evaluation = searchChild(tempBoards, stack, move, splitPoint.depth, alpha,
+                                     splitPoint.beta, true, 0, singularExtension);
+
+        // Evaluation of aborted search is useless.
+        if (!isSearchStopped()) {
+            std::lock_guard lock(splitPoint.mutex);
+            if (evaluation > splitPoint.bestEvaluation) {
+                splitPoint.bestEvaluation = evaluation;
+                splitPoint.bestMove = move;
+                // Alpha is only written under the lock, other threads read it without the lock
+                // for the window of their next move.
+                if (evaluation > splitPoint.alpha.load(std::memory_order_relaxed)) {
+                    splitPoint.alpha.store(evaluation, std::memory_order_relaxed);
+                    if (splitPoint.pvNode) {
+                        splitPoint.pv.assign(1, move);
+                        splitPoint.pv.insert(splitPoint.pv.end(), getPv(stack + 1),
+                                             getPv(stack + 1) + (stack + 1)->pvLength);
+                    }
+                }
+                if (evaluation >= splitPoint.beta)
+                    splitPoint.cutoff = true;
+            }
+        }
+
+        std::copy(savedStack.begin(), savedStack.end(), stack - 1);
+        std::copy(savedPv.begin(), savedPv.end(), savedPvBegin);
+        m_splitPoint = previousSplitPoint;
+        m_zobristKeysHistory = previousZobristKeysHistory;
+    }
+    splitPoint.pendingMoves.fetch_sub(1, std::memory_order_release);
+}
+
+Search::IterationResult Search::iterativeDeepening(const PieceBitBoards& bitBoards,
+                                                   unsigned int depth, int alpha, int beta,
+                                                   const std::vector<Move>& excludedMoves,
+                                                   Move lineMove)
+{
+    std::vector<Move> moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(bitBoards);
+
+    int bestEvaluation = alpha;
+    Move bestMove(0, 0, 0, 0);
+    auto foundShortestMate = false;
+    auto rootNodes = getCountNodes();
+    uint64_t bestMoveNodes = 0;
+    PieceBitBoards tempBoards = bitBoards;
+    auto root = &m_searchStack[s_stackOffset];
+    root->pvLength = 0;
+    root->followPv = true;
+
+    // Here we must guarantee that the best move from the previous iteration is searched first.
+    bool firstMove = true;
+    MoveScores scores;
+    scoreMoves(moves, bitBoards, root, scores);
+    // Lines after the first have no transposition table move, their moves are ordered by root
+    // move evaluations from previous searches, before all moves without one. Move of the line at
+    // previous depth is first.
+    for (size_t i = 0; i < moves.size(); i++) {
+        auto rootMove = std::find_if(
+            m_rootMoveEvaluations.begin(), m_rootMoveEvaluations.end(),
+            [&](const std::pair<Move, int>& evaluation) { return evaluation.first == moves[i]; });
+        if (moves[i] == lineMove)
+            scores[i] = 2 * Evaluate::infinity;
+        else if (!excludedMoves.empty() && rootMove != m_rootMoveEvaluations.end())
+            scores[i] = Evaluate::infinity + rootMove->second;
+    }
+    for (size_t i = 0; i < moves.size(); i++) {
+        pickNextMove(moves, scores, i);
+        auto move = moves[i];
+        if (std::find(excludedMoves.begin(), excludedMoves.end(), move) != excludedMoves.end())
+            continue;
+        auto moveNodes = getCountNodes();
+        tempBoards.applyMove(move);
+
+        // Root is a PV node, only the first move is searched with full window (see negamax).
+        int evaluation = 0;
+        if (firstMove)
+            evaluation =
+                searchChild(tempBoards, root, move, depth, bestEvaluation, beta, true);
+        else {
+            evaluation = searchChild(tempBoards, root, move, depth, bestEvaluation,
+                                     bestEvaluation + 1, false);
+            if (evaluation > bestEvaluation && evaluation < beta)
+                evaluation =
+                    searchChild(tempBoards, root, move, depth, bestEvaluation, beta, true);
+        }
+        firstMove = false;
+        moveNodes = getCountNodes() - moveNodes;
+
+        // If search was canceled, evaluation from this negamax search didn't reach leaf nodes,
+        // evaluation is useless.
+        if (!isRunning())
+            break;
+
+        auto rootMove = std::find_if(
+            m_rootMoveEvaluations.begin(), m_rootMoveEvaluations.end(),
+            [&](const std::pair<Move, int>& evaluation) { return evaluation.first == move; });
+        if (rootMove != m_rootMoveEvaluations.end())
+            rootMove->second = evaluation;
+        else
+            m_rootMoveEvaluations.push_back({move, evaluation});
+
+        if (evaluation > bestEvaluation) {
+            bestEvaluation = evaluation;
+            bestMove = move;
+            bestMoveNodes = moveNodes;
+            updatePv(root, move);
+        }
+
+        // Fail high, evaluation is outside of aspiration window and will be searched again.
+        if (bestEvaluation >= beta)
+            break;
+
+        if (bestEvaluation >= Evaluate::mateScore - static_cast<int>(depth)) {
+            foundShortestMate = true;
+            break;
+        }
+
+        tempBoards = bitBoards;
+    }
+
+    // Important for move ordering in iterative deepening, search previous move first. Do not store
+    // false evaluation.
+    if (isRunning() && !(bestMove == Move(0, 0, 0, 0)) && excludedMoves.empty()) {
+        auto typeOfNode = (bestEvaluation >= beta) ? TranspositionTable::TypeOfNode::lower
+                                                   : TranspositionTable::TypeOfNode::exact;
+        m_transpositionTable.store(bitBoards.zobristKey, bestEvaluation, depth, typeOfNode,
+                                   bestMove);
+        if (m_threadIndex == 0 && typeOfNode == TranspositionTable::TypeOfNode::exact)
+            CHESS_LOG_INFO("Iterative deepening depth {} search evaluation: {}", depth,
+                           bestEvaluation);
+    }
+
+    std::vector<Move> pv;
+    if (!(bestMove == Move(0, 0, 0, 0))) {
+        pv.assign(getPv(root), getPv(root) + root->pvLength);
+        extendPvFromTable(bitBoards, pv);
+    }
+
+    rootNodes = getCountNodes() - rootNodes;
+    auto bestMoveNodesFraction =
+        static_cast<double>(bestMoveNodes) / static_cast<double>(std::max(rootNodes, uint64_t{1}));
+    return {bestMove, bestEvaluation, foundShortestMate, bestMoveNodesFraction, pv};
+}
+
+bool Search::skipDepth(unsigned int depth) const
+{
+    if (m_threadIndex == 0)
+        return false;
+    auto index = (m_threadIndex - 1) % s_skipSize.size();
+    return ((depth + s_skipPhase[index]) / s_skipSize[index]) % 2 != 0;
+}
+
+Search::IterationResult Search::aspirationSearch(const PieceBitBoards& bitBoards,
+                                                 unsigned int depth, unsigned int multiPv,
+                                                 std::optional<int> previousEvaluation,
+                                                 const std::vector<Move>& excludedMoves,
+                                                 Move lineMove,
+                                                 const IterationCallback& onIterationCompleted)
+{
+    // Aspiration window around previous evaluation. Mate scores change with depth, so search
+    // them with full window.
+    int alpha = Evaluate::negativeMateScore;
+    int beta = Evaluate::infinity;
+    int window = s_aspirationWindow;
+    bool useAspirationWindow = previousEvaluation.has_value() &&
+                               std::abs(*previousEvaluation) < Evaluate::mateThreshold;
+    if (useAspirationWindow) {
+        alpha = *previousEvaluation - window;
+        beta = *previousEvaluation + window;
+    }
+
+    IterationResult result =
+        iterativeDeepening(bitBoards, depth, alpha, beta, excludedMoves, lineMove);
+    std::optional<IterationResult> failHigh;
+    while (isRunning() && useAspirationWindow) {
+        auto typeOfNode = TranspositionTable::TypeOfNode::exact;
+        window *= 2;
+        if (result.evaluation <= alpha && alpha > Evaluate::negativeMateScore) {
+            typeOfNode = TranspositionTable::TypeOfNode::upper;
+            alpha = (window > s_maxAspirationWindow)
+                        ? Evaluate::negativeMateScore
+                        : std::max(alpha - window, Evaluate::negativeMateScore);
+        }
+        else if (result.evaluation >= beta && beta < Evaluate::infinity) {
+            typeOfNode = TranspositionTable::TypeOfNode::lower;
+            beta = (window > s_maxAspirationWindow) ? Evaluate::infinity : beta + window;
+            // Move that failed high is better than previous best move, it is searched first and
+            // kept in case the re-search is canceled before it completes.
+            failHigh = result;
+            lineMove = result.bestMove;
+            m_previousPv = result.pv;
+        }
+        else
+            break;
+
+        if (m_threadIndex == 0) {
+            CHESS_LOG_DEBUG("Aspiration window fail {} at depth {}, evaluation {}.",
+                            (typeOfNode == TranspositionTable::TypeOfNode::upper) ? "low"
+                                                                                  : "high",
+                            depth, result.evaluation);
+        }
+        if (onIterationCompleted)
+            onIterationCompleted({depth, result.evaluation, typeOfNode, result.bestMove,
+                                  result.bestMoveNodesFraction, multiPv, result.pv});
+        result = iterativeDeepening(bitBoards, depth, alpha, beta, excludedMoves, lineMove);
+    }
+    if (!isRunning() && failHigh.has_value())
+        return *failHigh;
+    return result;
+}
+
+Search::Result Search::run(const PieceBitBoards& bitBoards,
+                           const std::vector<uint64_t>& zobristKeysHistory, unsigned int depthLimit,
+                           const IterationCallback& onIterationCompleted)
+{
+    // Principal variation of the best move, which is its first move, and its evaluation from the
+    // same iteration.
+    std::vector<Move> pv;
+    int evaluation = 0;
+    unsigned int depthSearched = 0;
+    m_stopped = !isRunning();
+    m_zobristKeysHistory = &zobristKeysHistory;
+    std::fill(m_searchStack.begin(), m_searchStack.end(), SearchStack());
+    m_rootMoveEvaluations.clear();
+
+    // Results of MultiPV lines from the previous depth, first line is the best.
+    auto legalMoves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(bitBoards);
+    auto numberOfLines = std::min<size_t>(m_multiPv, legalMoves.size());
+    std::vector<IterationInfo> lines;
+
+    // Iterative deepening
+    for (unsigned int depth = 1; depth <= depthLimit; depth++) {
+        if (!isRunning())
+            break;
+        if (skipDepth(depth))
+            continue;
+
+        std::vector<IterationInfo> depthLines;
+        std::vector<Move> lineMoves;
+        bool isShortestMate = false;
+        for (unsigned int line = 0; line < numberOfLines; line++) {
+            const IterationInfo* previousLine = (line < lines.size()) ? &lines[line] : nullptr;
+            m_previousPv = (previousLine != nullptr) ? previousLine->pv : std::vector<Move>();
+            auto result = aspirationSearch(
+                bitBoards, depth, line + 1,
+                (previousLine != nullptr) ? std::optional(previousLine->evaluation) : std::nullopt,
+                lineMoves, (previousLine != nullptr) ? previousLine->bestMove : Move(0, 0, 0, 0),
+                onIterationCompleted);
+
+            if (line == 0) {
+                depthSearched = depth;
+                // We can update previous move even if search was canceled, because best move
+                // from previous iteration (or move that failed high) is searched first (and next
+                // move in the search must be searched to the leafs). We still have to check for
+                // null move, as it can be returned, if iterative deepening was canceled during
+                // first iteration.
+                if (!(result.bestMove == Move(0, 0, 0, 0))) {
+                    pv = result.pv;
+                    evaluation = result.evaluation;
+                }
+                isShortestMate = result.isShortestMate;
+            }
+            if (!isRunning() || result.bestMove == Move(0, 0, 0, 0))
+                break;
+            lineMoves.push_back(result.bestMove);
+            depthLines.push_back({depth, result.evaluation, TranspositionTable::TypeOfNode::exact,
+                                  result.bestMove, result.bestMoveNodesFraction, line + 1,
+                                  result.pv});
+        }
+
+        // Lines of a canceled depth are incomplete, they are not reported.
+        if (!isRunning() || depthLines.size() < numberOfLines)
+            continue;
+        lines = std::move(depthLines);
+        if (onIterationCompleted) {
+            for (const auto& line : lines)
+                onIterationCompleted(line);
+        }
+        // With more lines, the other lines can still improve.
+        if (isShortestMate && numberOfLines == 1)
+            break;
+    }
+    // Stopped (very small node or time limit) before any root move was searched.
+    if (pv.empty() && !legalMoves.empty())
+        pv.push_back(legalMoves[0]);
+    return {pv.empty() ? Move(0, 0, 0, 0) : pv[0], depthSearched, evaluation, pv};
+}
+
+unsigned int Search::getCountTranspositions() const
+{
+    return m_countTranspositions;
+}
+
+unsigned int Search::getCountMaxCheckExtensions() const
+{
+    return m_countMaxCheckExtensions;
+}
+
+unsigned int Search::getCountInternalIterativeDeepening() const
+{
+    return m_countInternalIterativeDeepening;
+}
+
+unsigned int Search::getCountInternalIterativeReductions() const
+{
+    return m_countInternalIterativeReductions;
+}
+
+unsigned int Search::getCountSingularExtensions() const
+{
+    return m_countSingularExtensions;
+}
+
+uint64_t Search::getCountProbCutTries() const
+{
+    return m_countProbCutTries;
+}
+
+uint64_t Search::getCountProbCuts() const
+{
+    return m_countProbCuts;
+}
+
+uint64_t Search::getCountCutoffs() const
+{
+    return m_countCutoffs;
+}
+
+uint64_t Search::getSumCutoffMoveNumbers() const
+{
+    return m_sumCutoffMoveNumbers;
+}
+
+uint64_t Search::getCountNodes() const
+{
+    return m_countNodes.load(std::memory_order_relaxed);
+}
+
+void Search::setThreadPool(WorkStealingPool* threadPool)
+{
+    m_threadPool = threadPool;
+}
+
+void Search::setMultiPv(unsigned int multiPv)
+{
+    m_multiPv = std::max(multiPv, 1u);
+}
+
+void Search::setNodeLimit(std::optional<uint64_t> nodeLimit)
+{
+    m_nodeLimit = nodeLimit;
+}
+
+void Search::setProbCut(bool probCut)
+{
+    m_probCut = probCut;
+}
+
+void Search::clear()
+{
+    for (auto& colorHistory : m_history)
+        for (auto& originHistory : colorHistory)
+            originHistory.fill(0);
+    std::fill(m_counterMoves.begin(), m_counterMoves.end(), Move(0, 0, 0, 0));
+    for (auto& pieceHistory : m_captureHistory)
+        for (auto& destinationHistory : pieceHistory)
+            destinationHistory.fill(0);
+    for (auto* continuationHistory : {&m_continuationHistory, &m_followUpHistory})
+        for (auto& previousMoveHistory : *continuationHistory)
+            for (auto& pieceHistory : previousMoveHistory)
+                pieceHistory.fill(0);
+}
+
+void Search::scoreMoves(const std::vector<Move>& moves, const PieceBitBoards& boards,
+                        const SearchStack* stack, MoveScores& scores, bool useTranspositions)
+{
+    Move bestMove(0, 0, 0, 0);
+    Move pvMove(0, 0, 0, 0);
+    if (stack->followPv && stack->ply < m_previousPv.size())
+        pvMove = m_previousPv[stack->ply];
+
+    // Important so best move from previous search is searched first.
+    if (useTranspositions) {
+        auto entry = m_transpositionTable.getEntry(boards.zobristKey);
+        if (entry.has_value())
+            bestMove = entry->bestMove;
+    }
+
+    for (size_t i = 0; i < moves.size(); i++) {
+        auto move = moves[i];
+        int moveScore = 0;
+
+        if (move == pvMove) {
+            scores[i] = s_pvMoveScore;
+            continue;
+        }
+        if (move == bestMove) {
+            scores[i] = s_transpositionMoveScore;
+            continue;
+        }
+
+        auto movingPiece = boards.getPieceTypeWithSetBitAtPosition(move.origin).getPieceFigure();
+        if (movingPiece == PieceFigure::Empty) {
+            CHESS_LOG_ERROR("No piece at origin of move.");
+            scores[i] = Evaluate::negativeInfinity;
+            continue;
+        }
+
+        auto capturedPiece = (move.specialMoveFlag == 2)
+                                 ? PieceFigure::Pawn
+                                 : boards.getPieceTypeWithSetBitAtPosition(move.destination)
+                                       .getPieceFigure();
+        // Static exchange evaluation splits captures and promotions in winning or equal ones,
+        // searched before quiet moves and ordered by MVV-LVA, and losing ones, searched last.
+        if (capturedPiece != PieceFigure::Empty || move.specialMoveFlag == 1) {
+            auto exchange = Evaluate::staticExchangeEvaluation(boards, move);
+            if (exchange >= 0) {
+                moveScore = s_goodCaptureScore +
+                            s_mvvLva[static_cast<size_t>(capturedPiece)]
+                                    [static_cast<size_t>(movingPiece)] +
+                            getCaptureHistory(boards, move) / s_captureHistoryDivisor;
+                scorePromotion(move, moveScore);
+            }
+            else
+                moveScore = s_badCaptureScore + exchange;
+        }
+        else if (isKillerMove(stack, move))
+            moveScore = (stack->killerMoves[0] == move) ? s_killerMoveScore
+                                                         : s_killerMoveScore - 1;
+        else if (isCounterMove(stack, move))
+            moveScore = s_counterMoveScore;
+        else {
+            // Quiet moves that hang the moved piece are searched after other quiet moves. Quiet
+            // moves stay between counter move and losing captures.
+            auto hangingPenalty = std::min(Evaluate::staticExchangeEvaluation(boards, move), 0);
+            moveScore = std::clamp(getHistory(boards.currentMoveColor, move) +
+                                       getContinuationHistory(boards, stack, move) + hangingPenalty,
+                                   s_badCaptureScore + 1, s_counterMoveScore - 1);
+        }
+
+        scores[i] = moveScore;
+    }
+}
+
+} // namespace chessAi
@@ -0,0 +1,576 @@
+#pragma once
+
+#include "Move.h"
+#include "TranspositionTable.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+namespace chessAi
+{
+
+struct PieceBitBoards;
+class TimeManager;
+class WorkStealingPool;
+
+/**
+ * Negamax search of one thread. Every search thread has its own search state, transposition table
+ * and stop flag are shared between all threads.
+ *
+ * Threads either search the same root independently (Lazy SMP) or, when a thread pool is set, split
+ * nodes after the first move is searched and let idle workers steal remaining moves (Young Brothers
+ * Wait).
+ *
+ * https://www.chessprogramming.org/Lazy_SMP
+ * https://www.chessprogramming.org/Young_Brothers_Wait_Concept
+ */
+class Search
+{
+public:
+    // More than maximum number of legal moves in a chess position.
+    inline static constexpr size_t s_maxMoves = 256;
+    /**
+     * Move ordering scores, index of score is the index of move in the move list.
+     */
+    using MoveScores = std::array<int, s_maxMoves>;
+
+    /**
+     * Result of a completed iterative deepening depth, or of root search that failed outside of
+     * the aspiration window.
+     */
+    struct IterationInfo
+    {
+        unsigned int depth;
+        int evaluation;
+        // Exact, or upper (fail low) or lower (fail high) bound.
+        TranspositionTable::TypeOfNode bound;
+        // Null move on fail low.
+        Move bestMove;
+        // Fraction of root nodes of this thread spent searching the best move.
+        double bestMoveNodesFraction;
+        // Line number with MultiPV, 1 is the best line.
+        unsigned int multiPv = 1;
+        // Principal variation starting with best move, empty on fail low.
+        std::vector<Move> pv = {};
+    };
+
+    /**
+     * Result of run.
+     */
+    struct Result
+    {
+        // Null move only if there is no legal move.
+        Move bestMove;
+        // Completed iterative deepening depth.
+        unsigned int depth;
+        // Evaluation of the principal variation, from the same (possibly canceled) iteration, 0 if
+        // no root move was searched.
+        int evaluation;
+        // Principal variation starting with best move.
+        std::vector<Move> pv;
+    };
+
+    /**
+     * Called by the main thread (thread index 0) after each completed iterative deepening depth
+     * and when root search fails outside of the aspiration window. With MultiPV it is called for
+     * each line, after all lines of the depth are searched.
+     */
+    using IterationCallback = std::function<void(const IterationInfo&)>;
+
+    /**
+     * @param runSearch Shared stop flag, cleared by any thread that reaches hard time limit.
+     * @param threadIndex 0 is the main thread, helper threads skip some iterative deepening
+     * depths so threads search different depths at the same time.
+     */
+    Search(TranspositionTable& transpositionTable, std::atomic<bool>& runSearch,
+           const TimeManager& timeManager, unsigned int threadIndex);
+
+    /**
+     * Run iterative deepening until depth limit is reached, shortest mate is found or search is
+     * stopped.
+     *
+     * @return Best move, depth to which the search was done, evaluation and principal variation.
+     */
+    Result run(const PieceBitBoards& bitBoards, const std::vector<uint64_t>& zobristKeysHistory,
+               unsigned int depthLimit, const IterationCallback& onIterationCompleted);
+
+    /**
+     * Set to enable split point search in negamax, nullptr disables it.
+     */
+    void setThreadPool(WorkStealingPool* threadPool);
+
+    /**
+     * Number of best lines searched at each depth (1 by default). Line n searches root moves
+     * except best moves of lines 1 to n - 1, lines share the transposition table, so each line
+     * after the first costs much less than a full search. Best move is the move of the first
+     * line.
+     */
+    void setMultiPv(unsigned int multiPv);
+
+    /**
+     * Search of this thread stops (and clears the shared stop flag) when it has searched
+     * nodeLimit nodes, nullopt disables the limit. Nodes are counted exactly, in negamax and in
+     * quiescence search, so with one thread search stops at the same node every time.
+     */
+    void setNodeLimit(std::optional<uint64_t> nodeLimit);
+
+    /**
+     * Enable ProbCut (enabled by default), disabled for A/B testing.
+     */
+    void setProbCut(bool probCut);
+
+    /**
+     * Clear move ordering heuristics (new game). History tables are kept between searches, as
+     * most of them stay valid for the next move.
+     */
+    void clear();
+
+    /**
+     * Reset node count and other statistics, called before each search.
+     */
+    void resetStatistics();
+
+    /**
+     * Stop only the search of this thread, can be called from another thread. Search stays
+     * aborted (run returns immediately) until clearAbort is called.
+     */
+    void abort();
+    void clearAbort();
+
+    unsigned int getCountTranspositions() const;
+    unsigned int getCountMaxCheckExtensions() const;
+    /**
+     * Number of internal iterative deepening searches at PV nodes and internal iterative
+     * reductions at other nodes.
+     */
+    unsigned int getCountInternalIterativeDeepening() const;
+    unsigned int getCountInternalIterativeReductions() const;
+    unsigned int getCountSingularExtensions() const;
+    /**
+     * Number of captures verified by ProbCut and number of them that cut off the node.
+     */
+    uint64_t getCountProbCutTries() const;
+    uint64_t getCountProbCuts() const;
+    /**
+     * Number of beta cutoffs in negamax and sum of their move numbers (first move is 0). Average
+     * cutoff move number measures move ordering quality.
+     */
+    uint64_t getCountCutoffs() const;
+    uint64_t getSumCutoffMoveNumbers() const;
+    /**
+     * Number of negamax and quiescence search nodes. Can be read from another thread.
+     */
+    uint64_t getCountNodes() const;
+
+private:
+    // Moved piece index of null move and of sentinel search stack entries.
+    inline static constexpr unsigned int s_noPiece = 12;
+
+    /**
+     * Search state of one ply. Stack is preallocated for s_maxPly plies, searched nodes get a
+     * pointer to their entry, entries of parent nodes are before it. Entries before the root are
+     * sentinels with no moved piece, so nodes can look two plies back without checks.
+     */
+    struct SearchStack
+    {
+        // Distance from the root.
+        unsigned int ply = 0;
+        // Move searched from this node and its piece index (0-11), s_noPiece for null move.
+        Move currentMove{0, 0, 0, 0};
+        unsigned int movedPiece = s_noPiece;
+        // Move excluded from the search of this node, set during singular extension search.
+        Move excludedMove{0, 0, 0, 0};
+        // Two quiet moves that caused beta cutoff at this ply, most recent first.
+        std::array<Move, 2> killerMoves{Move(0, 0, 0, 0), Move(0, 0, 0, 0)};
+        // Static evaluation of the node, 0 in check.
+        int staticEvaluation = 0;
+        // Number of check and singular extensions on the path from the root.
+        unsigned int numExtensions = 0;
+        // Length of the principal variation from this node, moves are in the PV table row of
+        // the ply.
+        unsigned int pvLength = 0;
+        // All moves from the root to this node are moves of the previous principal variation.
+        bool followPv = false;
+    };
+
+    /**
+     * Node whose remaining moves are searched in parallel. Owner of the split point waits (and
+     * helps) until all moves are searched, so references to its stack stay valid.
+     */
+    struct SplitPoint
+    {
+        SplitPoint(const SplitPoint* parent, const PieceBitBoards& bitBoards,
+                   const std::vector<uint64_t>& zobristKeysHistory, const SearchStack* stack,
+                   unsigned int depth, int alpha, int beta, bool pvNode, Move singularMove,
+                   unsigned int pendingMoves);
+
+        /**
+         * True if a beta cutoff happened at this or any parent split point.
+         */
+        bool isAborted() const;
+
+        const SplitPoint* parent;
+        const PieceBitBoards& bitBoards;
+        const std::vector<uint64_t>& zobristKeysHistory;
+        // Stack entries of the split node and its parent, threads searching its moves need them
+        // for extensions, move ordering and continuation history of their children.
+        std::array<SearchStack, 2> stack;
+        unsigned int depth;
+        int beta;
+        bool pvNode;
+        // Transposition table move found singular at the split node, extended by every thread.
+        Move singularMove;
+        std::atomic<int> alpha;
+        std::atomic<bool> cutoff;
+        std::atomic<unsigned int> pendingMoves;
+        // Guards best evaluation, best move and principal variation.
+        std::mutex mutex;
+        int bestEvaluation;
+        Move bestMove;
+        // Principal variation of the last move that raised alpha at PV split point, empty if no
+        // move did.
+        std::vector<Move> pv;
+    };
+
+    struct IterationResult
+    {
+        Move bestMove;
+        int evaluation;
+        bool isShortestMate;
+        double bestMoveNodesFraction;
+        std::vector<Move> pv;
+    };
+
+    /**
+     * Alpha-Beta pruning, alpha keeps best score current active color could achieve, beta keeps
+     * opponents.
+     *
+     * Principal variation search, pvNode is true for nodes searched with full window (first moves
+     * from the root), other nodes are searched with null window (beta = alpha + 1).
+     *
+     * If search is canceled during the search, return positive or negative infinity evaluation.
+     *
+     * Null move pruning is tried at non-PV nodes, allowNullMove is false right after a null move
+     * and in its verification search.
+     */
+    int negamax(const PieceBitBoards& bitBoards, SearchStack* stack, unsigned int depth, int alpha,
+                int beta, bool pvNode, bool allowNullMove = true);
+
+    /**
+     * Search position after a move with negamax, with 3 fold repetition detection and check
+     * extensions. Stack and depth are of the parent node. Evaluation is from the perspective of
+     * the color that made the move. tempBoards is position after the move.
+     *
+     * Search depth is reduced by reduction (late move reductions), unless the move gives check.
+     * Moves that give check and singular moves are extended by one ply.
+     */
+    int searchChild(const PieceBitBoards& tempBoards, SearchStack* stack, Move move,
+                    unsigned int depth, int alpha, int beta, bool pvNode,
+                    unsigned int reduction = 0, bool singularExtension = false);
+
+    /**
+     * ProbCut at cut nodes, a capture winning enough material by static exchange evaluation
+     * that also beats raised beta in quiescence search and in reduced depth search would most
+     * likely beat beta in full depth search too.
+     *
+     * @return Evaluation of the verified capture (stored as lower bound), nullopt if no capture
+     * was verified.
+     * https://www.chessprogramming.org/ProbCut
+     */
+    std::optional<int> probCut(const PieceBitBoards& bitBoards, SearchStack* stack,
+                               unsigned int depth, int beta,
+                               const std::optional<TranspositionTable::Entry>& tableEval);
+
+    /**
+     * Late move reduction of a move, moveNumber is the index of the move in move ordering. Only
+     * late quiet moves are reduced, never in check.
+     * https://www.chessprogramming.org/Late_Move_Reductions
+     */
+    unsigned int lateMoveReduction(const PieceBitBoards& bitBoards, const SearchStack* stack,
+                                   Move move, unsigned int depth, unsigned int moveNumber,
+                                   bool pvNode, bool inCheck) const;
+
+    /**
+     * Futility and move count pruning at shallow depth, only quiet moves that are not killers and
+     * don't give check are pruned. tempBoards is position after the move.
+     */
+    bool isPrunableQuietMove(const PieceBitBoards& bitBoards, const PieceBitBoards& tempBoards,
+                             const SearchStack* stack, Move move, unsigned int depth,
+                             unsigned int moveNumber, int alpha) const;
+
+    /**
+     * Update killer moves and countermove of current ply, history and continuation histories
+     * with quiet move that caused beta cutoff. Quiet moves among the first numFailedMoves of
+     * failedMoves (searched before it) get history malus.
+     */
+    void updateQuietMoveHeuristics(const PieceBitBoards& bitBoards, SearchStack* stack, Move move,
+                                   unsigned int depth, const std::vector<Move>& failedMoves,
+                                   unsigned int numFailedMoves);
+
+    /**
+     * Update capture history with capture that caused beta cutoff (nullptr if a quiet move caused
+     * it), captures among the first numFailedMoves of failedMoves get malus.
+     */
+    void updateCaptureHeuristics(const PieceBitBoards& bitBoards, const Move* move,
+                                 unsigned int depth, const std::vector<Move>& failedMoves,
+                                 unsigned int numFailedMoves);
+
+    /**
+     * History update with gravity, history stays within (-s_maxHistory, s_maxHistory) and big
+     * values change slower.
+     */
+    static void updateHistory(int& history, int bonus);
+
+    int getHistory(PieceColor color, Move move) const;
+    /**
+     * Sum of continuation histories of a quiet move, indexed by moves one and two plies before.
+     */
+    int getContinuationHistory(const PieceBitBoards& bitBoards, const SearchStack* stack,
+                               Move move) const;
+    int getCaptureHistory(const PieceBitBoards& bitBoards, Move move) const;
+    static bool isKillerMove(const SearchStack* stack, Move move);
+    bool isCounterMove(const SearchStack* stack, Move move) const;
+
+    /**
+     * Index of the move searched from a stack entry in counter move and continuation history
+     * tables, nullopt for null move and sentinel entries.
+     */
+    static std::optional<size_t> getMoveIndex(const SearchStack* stack);
+
+    /**
+     * Search younger brothers in parallel. Moves are pushed to the thread pool, this thread
+     * helps until all of them are searched.
+     *
+     * Principal variation of the node is updated if a younger brother raised alpha. Singular move
+     * of the node is extended like in negamax.
+     *
+     * @return Best evaluation and best move of the searched moves.
+     */
+    std::pair<int, Move> searchSplitPoint(const PieceBitBoards& bitBoards, SearchStack* stack,
+                                          const std::vector<Move>& moves, unsigned int depth,
+                                          int alpha, int beta, bool pvNode, bool inCheck,
+                                          Move singularMove);
+
+    void searchSplitPointMove(SplitPoint& splitPoint, Move move, unsigned int reduction);
+
+    /**
+     * Count a node. Every s_timeCheckNodes nodes the clock is checked against hard time limit and
+     * the shared stop flag is read, so there is no timer thread and no atomic read per node.
+     * Node limit is checked at every node.
+     */
+    void countNode();
+
+    /**
+     * Search is stopped by time, by stop flag or by a beta cutoff at split point above this node.
+     */
+    bool isSearchStopped() const;
+
+    /**
+     * Shared stop flag is not cleared and search of this thread is not aborted.
+     */
+    bool isRunning() const;
+
+    /**
+     * Run iterative deepening, with ordered moves from previous search.
+     * Return best move, its evaluation and true if move is shortest mate.
+     *
+     * Root is searched with (alpha, beta) aspiration window. If all moves fail low, null move and
+     * alpha are returned. If a move fails high, it is returned with its evaluation (lower bound).
+     *
+     * Because we order moves, best move from previous search is searched first. In that case we can
+     * update best move even if search for this iteration depth was not completed fully. Current
+     * move is better than previous best move.
+     *
+     * Excluded moves are skipped and line move (if not null) is searched first. Only the first line
+     * (no excluded moves) is stored in transposition table.
+     */
+    IterationResult iterativeDeepening(const PieceBitBoards& bitBoards, unsigned int depth,
+                                       int alpha, int beta,
+                                       const std::vector<Move>& excludedMoves, Move lineMove);
+
+    /**
+     * Search root at depth with aspiration window around previous evaluation of the line,
+     * window is widened until the result is inside of it. Fails are reported to the callback.
+     * Root moves searched by previous lines are excluded, move of the line at previous depth is
+     * searched first. After a fail high, the move that failed high is searched first and its
+     * principal variation is followed. If the search is canceled before a re-search completes,
+     * the last fail high result is returned.
+     */
+    IterationResult aspirationSearch(const PieceBitBoards& bitBoards, unsigned int depth,
+                                     unsigned int multiPv, std::optional<int> previousEvaluation,
+                                     const std::vector<Move>& excludedMoves, Move lineMove,
+                                     const IterationCallback& onIterationCompleted);
+
+    /**
+     * Score moves for move ordering, moves with higher score are searched first. We can
+     * (hopefully) prune more branches if moves are ordered from best to worst in negamax.
+     *
+     * @param useTranspositions Set to false to not use transpositions.
+     *
+     * Move of the previous principal variation is first at nodes on that variation, then
+     * transposition table move. Then captures and promotions that do not lose material
+     * by static exchange evaluation, ordered by Most Valuable Victim - Least Valuable Aggressor.
+     * Quiet moves are ordered by killer moves of current ply, history and static exchange
+     * evaluation of the moved piece. Losing captures are last.
+     */
+    void scoreMoves(const std::vector<Move>& moves, const PieceBitBoards& boards,
+                    const SearchStack* stack, MoveScores& scores, bool useTranspositions = true);
+
+    /**
+     * Evaluation of position without legal moves, mate is offset by ply so shorter mates are
+     * preferred.
+     */
+    static int evaluateEndGameType(const PieceBitBoards& boards, const SearchStack* stack);
+
+    /**
+     * Row of the triangular PV table of the node's ply, row of ply p has s_maxPly + 1 - p moves.
+     */
+    Move* getPv(const SearchStack* stack);
+
+    /**
+     * Principal variation of the node is move followed by principal variation of the child.
+     */
+    void updatePv(SearchStack* stack, Move move);
+
+    /**
+     * Principal variation is cut short where the search returned without searching the line
+     * (transposition table cutoff, split point of another thread). Extend it with transposition
+     * table moves, until the move is missing or illegal or a position repeats.
+     */
+    void extendPvFromTable(const PieceBitBoards& bitBoards, std::vector<Move>& pv) const;
+
+    /**
+     * Search captures until position is quiet and then return evaluation. Results are stored in
+     * transposition table with depth 0, delta pruning skips captures that can't raise alpha.
+     * https://www.chessprogramming.org/Delta_Pruning
+     */
+    int quiescenceSearch(const PieceBitBoards& bitBoards, SearchStack* stack, int alpha, int beta);
+
+    /**
+     * Helper threads skip depths in a pattern depending on thread index, so not all threads search
+     * the same depth.
+     */
+    bool skipDepth(unsigned int depth) const;
+
+private:
+    TranspositionTable& m_transpositionTable;
+    std::atomic<bool>& m_runSearch;
+    const TimeManager& m_timeManager;
+    std::atomic<bool> m_aborted;
+    // Stop flag as read at the last clock check.
+    bool m_stopped;
+    unsigned int m_threadIndex;
+    unsigned int m_multiPv;
+    bool m_probCut;
+    // Last evaluation of each searched root move (exact or bound), orders MultiPV lines.
+    std::vector<std::pair<Move, int>> m_rootMoveEvaluations;
+    unsigned int m_countTranspositions;
+    unsigned int m_countMaxCheckExtensions;
+    unsigned int m_countInternalIterativeDeepening;
+    unsigned int m_countInternalIterativeReductions;
+    unsigned int m_countSingularExtensions;
+    uint64_t m_countProbCutTries;
+    uint64_t m_countProbCuts;
+    uint64_t m_countCutoffs;
+    uint64_t m_sumCutoffMoveNumbers;
+    std::atomic<uint64_t> m_countNodes;
+    std::optional<uint64_t> m_nodeLimit;
+    WorkStealingPool* m_threadPool;
+    // Split point whose move this thread is currently searching, nullptr at root.
+    const SplitPoint* m_splitPoint;
+    // Positions played in the game before the root, for repetition detection.
+    const std::vector<uint64_t>* m_zobristKeysHistory;
+
+    inline static constexpr unsigned int s_maxPly = 128;
+    // Sentinel entries before the root entry of the search stack.
+    inline static constexpr size_t s_stackOffset = 2;
+    // Root entry is at s_stackOffset, children of nodes at s_maxPly - 1 are only evaluated.
+    std::vector<SearchStack> m_searchStack;
+    // Entry of the node at which this thread waits for its split point, nullptr if it doesn't.
+    const SearchStack* m_waitingStack;
+    // Triangular table, row of each ply holds principal variation of the last PV node searched
+    // at that ply.
+    std::vector<Move> m_pvTable;
+    // Principal variation of the line at previous depth, searched first.
+    std::vector<Move> m_previousPv;
+    // Nodes between clock checks, power of two.
+    inline static constexpr uint64_t s_timeCheckNodes = 1024;
+    inline static constexpr int s_maxHistory = 16384;
+    // Move ordering scores, previous principal variation move and transposition table move are
+    // first, then captures that do not lose material, killer moves, other moves ordered by
+    // history and losing captures.
+    inline static constexpr int s_pvMoveScore = 200000;
+    inline static constexpr int s_transpositionMoveScore = 100000;
+    inline static constexpr int s_goodCaptureScore = 30000;
+    inline static constexpr int s_badCaptureScore = -30000;
+    inline static constexpr int s_killerMoveScore = 20000;
+    inline static constexpr int s_counterMoveScore = s_killerMoveScore - 2;
+    // Capture history is scaled down, so it only reorders captures of similar MVV-LVA score.
+    inline static constexpr int s_captureHistoryDivisor = 16;
+    // Butterfly history indexed by color, origin and destination of quiet moves. Kept between
+    // searches until clear is called.
+    // https://www.chessprogramming.org/History_Heuristic
+    std::array<std::array<std::array<int, 64>, 64>, 2> m_history;
+    // Quiet move that caused beta cutoff as reply to opponent's move, indexed by piece index *
+    // 64 + destination of opponent's move.
+    // https://www.chessprogramming.org/Countermove_Heuristic
+    std::vector<Move> m_counterMoves;
+    // Capture history indexed by moving piece index, destination and captured figure.
+    std::array<std::array<std::array<int, 7>, 64>, 12> m_captureHistory;
+    // Continuation histories of quiet moves indexed by piece index * 64 + destination of the move
+    // one (or two) plies before, then by piece index and destination of the move.
+    // https://www.chessprogramming.org/History_Heuristic#Continuation_History
+    using ContinuationHistory = std::vector<std::array<std::array<int, 64>, 12>>;
+    ContinuationHistory m_continuationHistory;
+    ContinuationHistory m_followUpHistory;
+
+    // Nodes closer to the leafs are not worth splitting.
+    inline static constexpr unsigned int s_minSplitDepth = 3;
+    // Initial half width of the aspiration window around previous iteration evaluation. Window is
+    // doubled on each fail, above max width that side of the window is fully opened.
+    // https://www.chessprogramming.org/Aspiration_Windows
+    inline static constexpr int s_aspirationWindow = 60;
+    inline static constexpr int s_maxAspirationWindow = 1000;
+    // Null move pruning, reduction is increased with depth and with static evaluation above beta.
+    // Fail high at or above verification depth is verified with reduced search without null move.
+    // https://www.chessprogramming.org/Null_Move_Pruning
+    inline static constexpr unsigned int s_nullMoveMinDepth = 3;
+    inline static constexpr unsigned int s_nullMoveVerificationDepth = 8;
+    // Shallow depth pruning margins and limits, indexed by depth (up to s_shallowPruningMaxDepth).
+    // https://www.chessprogramming.org/Futility_Pruning
+    // https://www.chessprogramming.org/Razoring
+    inline static constexpr unsigned int s_shallowPruningMaxDepth = 3;
+    inline static constexpr std::array<int, 4> s_reverseFutilityMargins = {0, 150, 300, 450};
+    inline static constexpr std::array<int, 4> s_razoringMargins = {0, 300, 550, 800};
+    inline static constexpr std::array<int, 4> s_futilityMargins = {0, 200, 350, 500};
+    inline static constexpr std::array<unsigned int, 4> s_moveCountPruningLimits = {0, 8, 12, 18};
+    // Delta pruning safety margin above value of the captured piece.
+    inline static constexpr int s_deltaMargin = 200;
+    // Ranks from which pawns promote, disables delta pruning of the whole node.
+    inline static constexpr uint64_t s_whitePromotionRank = 0x000000000000FF00ULL;
+    inline static constexpr uint64_t s_blackPromotionRank = 0x00FF000000000000ULL;
+    // Internal iterative deepening (PV nodes) and reduction (other nodes) without a transposition
+    // table move at least as deep as depth - s_internalIterativeReduction.
+    // https://www.chessprogramming.org/Internal_Iterative_Deepening
+    inline static constexpr unsigned int s_internalIterativeMinDepth = 5;
+    inline static constexpr unsigned int s_internalIterativeReduction = 2;
+    // Singular extensions are tried from this depth, for transposition table entries at most
+    // depth margin shallower than the node. Singular beta is lowered by margin per depth.
+    // https://www.chessprogramming.org/Singular_Extensions
+    inline static constexpr unsigned int s_singularExtensionMinDepth = 7;
+    inline static constexpr unsigned int s_singularExtensionDepthMargin = 3;
+    inline static constexpr int s_singularExtensionMargin = 2;
+    // ProbCut is tried from this depth, captures must beat beta raised by margin in a search
+    // reduced by reduction.
+    inline static constexpr unsigned int s_probCutMinDepth = 5;
+    inline static constexpr unsigned int s_probCutReduction = 4;
+    inline static constexpr int s_probCutMargin = 200;
+    // Late move reductions start at this depth and move number (first move is 0).
+    inline static constexpr unsigned int s_lateMoveReductionMinDepth = 3;
+    inline static constexpr unsigned int s_lateMoveReductionMinMoveNumber = 3;
+};
+
+} // namespace chessAi
@@ -0,0 +1,153 @@
+#include "TimeManager.h"
+
+#include <algorithm>
+
+namespace chessAi
+{
+
+namespace
+{
+
+TimeManager::Clock::rep toTicks(TimeManager::Clock::time_point timePoint)
+{
+    return timePoint.time_since_epoch().count();
+}
+
+TimeManager::Clock::time_point fromTicks(const std::atomic<TimeManager::Clock::rep>& ticks)
+{
+    return TimeManager::Clock::time_point(
+        TimeManager::Clock::duration(ticks.load(std::memory_order_relaxed)));
+}
+
+} // namespace
+
+TimeManager::TimeManager(std::chrono::milliseconds moveOverhead)
+    : m_moveOverhead(moveOverhead), m_adaptive(true), m_pondering(false), m_scalable(false),
+      m_baseSoftLimit(), m_softLimit(), m_hardLimit(), m_startTime(toTicks(Clock::now())),
+      m_softDeadline(toTicks(Clock::time_point::max())),
+      m_hardDeadline(toTicks(Clock::time_point::max())), m_previousBestMove(0, 0, 0, 0),
+      m_stableIterations(0), m_previousEvaluation()
+{
+}
+
+void TimeManager::start(const TimeControl& timeControl)
+{
+    m_softLimit.reset();
+    m_hardLimit.reset();
+    m_scalable = false;
+    m_previousBestMove = Move(0, 0, 0, 0);
+    m_stableIterations = 0;
+    m_previousEvaluation.reset();
+
+    // At least 1 ms, so search always returns a move.
+    if (timeControl.moveTime.has_value()) {
+        auto moveTime =
+            std::max(*timeControl.moveTime - m_moveOverhead, std::chrono::milliseconds(1));
+        m_softLimit = moveTime;
+        m_hardLimit = moveTime;
+    }
+    else if (timeControl.time.has_value()) {
+        auto available =
+            std::max(*timeControl.time - m_moveOverhead, std::chrono::milliseconds(1));
+        auto movesToGo = (timeControl.movesToGo > 0)
+                             ? std::min(timeControl.movesToGo, s_maxMovesToGo)
+                             : s_defaultMovesToGo;
+
+        auto softLimit = available / movesToGo + timeControl.increment * 3 / 4;
+        auto hardLimit = std::min(softLimit * s_hardLimitFactor,
+                                  available * s_maxTimeUsagePercent / 100);
+        m_hardLimit = std::max(hardLimit, std::chrono::milliseconds(1));
+        m_softLimit = std::min(softLimit, *m_hardLimit);
+        m_scalable = true;
+    }
+    m_baseSoftLimit = m_softLimit;
+
+    auto startTime = Clock::now();
+    m_startTime = toTicks(startTime);
+    m_softDeadline =
+        toTicks(m_softLimit.has_value() ? startTime + *m_softLimit : Clock::time_point::max());
+    m_hardDeadline =
+        toTicks(m_hardLimit.has_value() ? startTime + *m_hardLimit : Clock::time_point::max());
+}
+
+void TimeManager::setMoveOverhead(std::chrono::milliseconds moveOverhead)
+{
+    m_moveOverhead = moveOverhead;
+}
+
+void TimeManager::setPondering(bool pondering)
+{
+    m_pondering = pondering;
+}
+
+bool TimeManager::isPondering() const
+{
+    return m_pondering;
+}
+
+void TimeManager::setAdaptive(bool adaptive)
+{
+    m_adaptive = adaptive;
+}
+
+void TimeManager::onIterationCompleted(Move bestMove, int evaluation,
+                                       double bestMoveNodesFraction)
+{
+    m_stableIterations = (bestMove == m_previousBestMove) ? m_stableIterations + 1 : 0;
+    m_previousBestMove = bestMove;
+    auto evaluationDrop = m_previousEvaluation.has_value() ? *m_previousEvaluation - evaluation : 0;
+    m_previousEvaluation = evaluation;
+
+    if (!m_adaptive || !m_scalable)
+        return;
+
+    auto stabilityFactor =
+        std::max(s_unstableFactor - s_stableIterationFactor * m_stableIterations,
+                 s_minStabilityFactor);
+    auto nodesFactor = std::max(s_nodesFactorBase - bestMoveNodesFraction, s_minNodesFactor);
+    auto scoreTrendFactor = std::clamp(1.0 + s_evaluationDropFactor * evaluationDrop,
+                                       s_minScoreTrendFactor, s_maxScoreTrendFactor);
+    auto scale = stabilityFactor * nodesFactor * scoreTrendFactor;
+
+    auto softLimit = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::duration<double, std::milli>(static_cast<double>(m_baseSoftLimit->count()) *
+                                                  scale));
+    m_softLimit = std::min(softLimit, *m_hardLimit);
+    m_softDeadline = toTicks(fromTicks(m_startTime) + *m_softLimit);
+}
+
+bool TimeManager::softLimitReached() const
+{
+    return !m_pondering.load(std::memory_order_relaxed) &&
+           Clock::now() >= fromTicks(m_softDeadline);
+}
+
+bool TimeManager::hardLimitReached() const
+{
+    return !m_pondering.load(std::memory_order_relaxed) &&
+           Clock::now() >= fromTicks(m_hardDeadline);
+}
+
+std::optional<std::chrono::milliseconds> TimeManager::getSoftLimit() const
+{
+    return m_softLimit;
+}
+
+std::optional<std::chrono::milliseconds> TimeManager::getHardLimit() const
+{
+    return m_hardLimit;
+}
+
+std::chrono::milliseconds TimeManager::getElapsedTime() const
+{
+    auto elapsed = Clock::now() - fromTicks(m_startTime);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+}
+
+std::chrono::microseconds TimeManager::getElapsedMicroseconds() const
+{
+    auto elapsed = Clock::now() - fromTicks(m_startTime);
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+}
+
+} // namespace chessAi
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Move.h"
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+
+namespace chessAi
+{
+
+/**
+ * Time parameters of a search, as given by UCI go command. Without move time and remaining time
+ * search is not limited by time.
+ */
+struct TimeControl
+{
+    // Fixed time for this move, remaining time is ignored if set.
+    std::optional<std::chrono::milliseconds> moveTime;
+    // Remaining time and increment of the side to move.
+    std::optional<std::chrono::milliseconds> time;
+    std::chrono::milliseconds increment{0};
+    // Moves until next time control, 0 if remaining time is for the rest of the game.
+    unsigned int movesToGo = 0;
+    // Search on opponent's time (go ponder), limits are not applied until ponderhit.
+    bool ponder = false;
+};
+
+/**
+ * Turns time control into soft and hard time limit of a search. Iterative deepening does not
+ * start a new depth after soft limit, search threads stop at hard limit. Move overhead (GUI and
+ * communication lag) is subtracted from available time.
+ *
+ * With clock based time control, soft limit is scaled after each completed depth. Search stops
+ * earlier when best move is stable and got most of the root nodes, and gets more time (up to hard
+ * limit) when best move changes or evaluation drops.
+ *
+ * While pondering, limits are computed but not applied. After ponderhit they apply from the
+ * start of the ponder search, so time spent pondering on the expected move is saved.
+ *
+ * Uses steady clock, limits are read by all search threads while the search runs.
+ * https://www.chessprogramming.org/Time_Management
+ */
+class TimeManager
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimeManager(std::chrono::milliseconds moveOverhead = std::chrono::milliseconds(0));
+
+    /**
+     * Compute limits for time control and start the clock.
+     */
+    void start(const TimeControl& timeControl);
+
+    void setMoveOverhead(std::chrono::milliseconds moveOverhead);
+
+    /**
+     * Set before the search is started, can be cleared from another thread by ponderhit.
+     */
+    void setPondering(bool pondering);
+    bool isPondering() const;
+
+    /**
+     * Enables soft limit scaling with search results, enabled by default.
+     */
+    void setAdaptive(bool adaptive);
+
+    /**
+     * Scale soft limit with result of a completed iterative deepening depth.
+     *
+     * @param bestMoveNodesFraction Fraction of root nodes spent searching the best move.
+     */
+    void onIterationCompleted(Move bestMove, int evaluation, double bestMoveNodesFraction);
+
+    /**
+     * Limits are never reached while pondering.
+     */
+    bool softLimitReached() const;
+    bool hardLimitReached() const;
+
+    /**
+     * Limits from the start of the search, nullopt if search is not limited by time.
+     */
+    std::optional<std::chrono::milliseconds> getSoftLimit() const;
+    std::optional<std::chrono::milliseconds> getHardLimit() const;
+
+    std::chrono::milliseconds getElapsedTime() const;
+    std::chrono::microseconds getElapsedMicroseconds() const;
+
+private:
+    std::chrono::milliseconds m_moveOverhead;
+    bool m_adaptive;
+    std::atomic<bool> m_pondering;
+    // Soft limit is only scaled for clock based time control, not for fixed move time.
+    bool m_scalable;
+    // Limits are only accessed by the thread that started the search.
+    std::optional<std::chrono::milliseconds> m_baseSoftLimit;
+    std::optional<std::chrono::milliseconds> m_softLimit;
+    std::optional<std::chrono::milliseconds> m_hardLimit;
+    // Start time and deadlines are also read by the UCI thread (stop, ponderhit) and by helper
+    // threads, so they are kept as clock ticks in atomics. Deadlines are compared on every clock
+    // poll, time point max if not limited.
+    std::atomic<Clock::rep> m_startTime;
+    std::atomic<Clock::rep> m_softDeadline;
+    std::atomic<Clock::rep> m_hardDeadline;
+    // Results of previous completed depths.
+    Move m_previousBestMove;
+    unsigned int m_stableIterations;
+    std::optional<int> m_previousEvaluation;
+
+    // Expected number of remaining moves in sudden death, and maximum used with moves to go.
+    inline static constexpr unsigned int s_defaultMovesToGo = 40;
+    inline static constexpr unsigned int s_maxMovesToGo = 50;
+    // Hard limit is a multiple of soft limit, but at most a fraction (in percent) of remaining
+    // time.
+    inline static constexpr int s_hardLimitFactor = 5;
+    inline static constexpr int s_maxTimeUsagePercent = 80;
+    // Soft limit scale factors. Best move stability factor decreases with each iteration in which
+    // best move didn't change. Node factor decreases with the fraction of root nodes of the best
+    // move. Score trend factor increases with evaluation drop (in centipawns) from previous depth.
+    inline static constexpr double s_unstableFactor = 1.3;
+    inline static constexpr double s_stableIterationFactor = 0.15;
+    inline static constexpr double s_minStabilityFactor = 0.6;
+    inline static constexpr double s_nodesFactorBase = 1.5;
+    inline static constexpr double s_minNodesFactor = 0.5;
+    inline static constexpr double s_evaluationDropFactor = 0.0025;
+    inline static constexpr double s_minScoreTrendFactor = 0.9;
+    inline static constexpr double s_maxScoreTrendFactor = 1.5;
+};
+
+} // namespace chessAi
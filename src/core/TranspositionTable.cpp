@@ -1,16 +1,20 @@
 #include "TranspositionTable.h"
 
+#include <algorithm>
+
 namespace chessAi
 {
 
 TranspositionTable::Entry::Entry()
-    : key(0), evaluation(0), depth(0), typeOfNode(TypeOfNode::none), bestMove(Move(0, 0, 0, 0))
+    : key(0), evaluation(0), depth(0), typeOfNode(TypeOfNode::none), bestMove(Move(0, 0, 0, 0)),
+      generation(0)
 {
 }
 
 TranspositionTable::Entry::Entry(uint64_t key, int evaluation, unsigned int depth,
-                                 TypeOfNode typeOfNode, Move bestMove)
-    : key(key), evaluation(evaluation), depth(depth), typeOfNode(typeOfNode), bestMove(bestMove)
+                                 TypeOfNode typeOfNode, Move bestMove, uint8_t generation)
+    : key(key), evaluation(evaluation), depth(depth), typeOfNode(typeOfNode), bestMove(bestMove),
+      generation(generation)
 {
 }
 
@@ -19,29 +23,77 @@ size_t TranspositionTable::hashFunction(uint64_t key)
     return key % s_numberOfEntires;
 }
 
+uint64_t TranspositionTable::packEntry(int evaluation, unsigned int depth, TypeOfNode typeOfNode,
+                                       Move bestMove, uint8_t generation)
+{
+    // Bits 0-31 evaluation, 32-39 depth, 40-41 type of node, 42-47 generation, 48-63 best move.
+    uint64_t move = static_cast<uint64_t>(bestMove.origin) |
+                    (static_cast<uint64_t>(bestMove.destination) << 6) |
+                    (static_cast<uint64_t>(bestMove.promotion) << 12) |
+                    (static_cast<uint64_t>(bestMove.specialMoveFlag) << 14);
+    return static_cast<uint64_t>(static_cast<uint32_t>(evaluation)) |
+           (static_cast<uint64_t>(std::min(depth, 255u)) << 32) |
+           (static_cast<uint64_t>(typeOfNode) << 40) |
+           (static_cast<uint64_t>(generation & s_generationMask) << 42) | (move << 48);
+}
+
+TranspositionTable::Entry TranspositionTable::unpackEntry(uint64_t key, uint64_t data)
+{
+    Move bestMove(static_cast<uint16_t>((data >> 48) & 0x3F),
+                  static_cast<uint16_t>((data >> 54) & 0x3F),
+                  static_cast<uint16_t>((data >> 60) & 0x3),
+                  static_cast<uint16_t>((data >> 62) & 0x3));
+    return Entry(key, static_cast<int>(static_cast<uint32_t>(data & 0xFFFFFFFF)),
+                 static_cast<unsigned int>((data >> 32) & 0xFF),
+                 static_cast<TypeOfNode>((data >> 40) & 0x3), bestMove,
+                 static_cast<uint8_t>((data >> 42) & s_generationMask));
+}
+
 TranspositionTable::TranspositionTable()
-    : m_table(std::make_unique<std::array<Entry, s_numberOfEntires>>())
+    : m_table(std::make_unique<std::array<Slot, s_numberOfEntires>>()), m_generation(0)
 {
 }
 
 void TranspositionTable::store(uint64_t zobristHash, int evaluation, unsigned int depth,
                                TypeOfNode typeOfNode, Move bestMove)
 {
-    m_table->at(hashFunction(zobristHash)) =
-        std::move(Entry(zobristHash, evaluation, depth, typeOfNode, bestMove));
+    auto& slot = (*m_table)[hashFunction(zobristHash)];
+
+    // Empty slot has data 0, torn entry is replaced as its key doesn't match any position.
+    auto storedData = slot.data.load(std::memory_order_relaxed);
+    auto storedKey = slot.keyXorData.load(std::memory_order_relaxed) ^ storedData;
+    if (storedData != 0 && storedKey != zobristHash) {
+        auto stored = unpackEntry(storedKey, storedData);
+        if (stored.generation == m_generation && depth + s_replaceDepthMargin < stored.depth)
+            return;
+    }
+
+    auto data = packEntry(evaluation, depth, typeOfNode, bestMove, m_generation);
+    slot.keyXorData.store(zobristHash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+std::optional<TranspositionTable::Entry> TranspositionTable::getEntry(uint64_t zobristHash) const
+{
+    const auto& slot = (*m_table)[hashFunction(zobristHash)];
+    auto data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) != zobristHash)
+        return std::nullopt;
+    return unpackEntry(zobristHash, data);
 }
 
-const TranspositionTable::Entry* TranspositionTable::getEntry(uint64_t zobristHash)
+void TranspositionTable::newSearch()
 {
-    auto entry = &m_table->at(hashFunction(zobristHash));
-    if (entry->key == zobristHash)
-        return entry;
-    return nullptr;
+    m_generation = (m_generation + 1) & s_generationMask;
 }
 
 void TranspositionTable::clear()
 {
-    m_table->fill(Entry());
+    for (auto& slot : *m_table) {
+        slot.keyXorData.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed);
+    }
+    m_generation = 0;
 }
 
-} // namespace chessAi
\ No newline at end of file
+} // namespace chessAi
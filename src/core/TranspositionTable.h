@@ -2,9 +2,23 @@
 
 #include "PieceBitBoards.h"
 
+#include <atomic>
+#include <optional>
+
 namespace chessAi
 {
 
+/**
+ * Transposition table shared by all search threads.
+ *
+ * Entries are stored lockless: key is stored xor-ed with packed data, so an entry that was
+ * written by two threads at the same time is detected on read and ignored.
+ * https://www.chessprogramming.org/Shared_Hash_Table#Lockless
+ *
+ * Table is kept between searches of a game. Each entry stores the generation (search) in which
+ * it was written. Entries of previous searches are always replaced, entries of the current search
+ * are replaced by the same position or by a search not much shallower.
+ */
 class TranspositionTable
 {
 public:
@@ -19,32 +33,65 @@ public:
     {
         Entry();
         Entry(uint64_t key, int evaluation, unsigned int depth, TypeOfNode typeOfNode,
-              Move bestMove);
+              Move bestMove, uint8_t generation);
 
         uint64_t key;
         int evaluation;
         unsigned int depth;
         TypeOfNode typeOfNode;
         Move bestMove;
+        uint8_t generation;
     };
 
 public:
     TranspositionTable();
 
+    /**
+     * Depth is stored in 8 bits, deeper searches are stored as depth 255.
+     */
     void store(uint64_t zobristHash, int evaluation, unsigned int depth, TypeOfNode typeOfNode,
                Move bestMove);
 
-    const Entry* getEntry(uint64_t zobristHash);
+    /**
+     * Returns a copy, because entry can be overwritten by another thread while it is used.
+     */
+    std::optional<Entry> getEntry(uint64_t zobristHash) const;
+
+    /**
+     * Start a new generation, called before each search. Not thread safe, search threads must
+     * not be running.
+     */
+    void newSearch();
 
+    /**
+     * Remove all entries (new game). Not thread safe, search threads must not be running.
+     */
     void clear();
 
 private:
+    struct Slot
+    {
+        std::atomic<uint64_t> keyXorData{0};
+        std::atomic<uint64_t> data{0};
+    };
+
     static size_t hashFunction(uint64_t key);
 
+    static uint64_t packEntry(int evaluation, unsigned int depth, TypeOfNode typeOfNode,
+                              Move bestMove, uint8_t generation);
+    static Entry unpackEntry(uint64_t key, uint64_t data);
+
 private:
-    // 64 MB size
+    // 56 MB size
     inline static constexpr size_t s_numberOfEntires = 3532045;
-    std::unique_ptr<std::array<Entry, s_numberOfEntires>> m_table;
+    std::unique_ptr<std::array<Slot, s_numberOfEntires>> m_table;
+    // Generation is stored in 6 bits and wraps around.
+    uint8_t m_generation;
+
+    inline static constexpr uint8_t s_generationMask = 0x3F;
+    // Entry of the current search is not replaced by a different position searched more than
+    // margin plies shallower.
+    inline static constexpr unsigned int s_replaceDepthMargin = 3;
 };
 
 } // namespace chessAi
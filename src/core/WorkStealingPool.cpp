@@ -0,0 +1,65 @@
+#include "WorkStealingPool.h"
+#include "Search.h"
+
+namespace chessAi
+{
+
+WorkStealingPool::WorkStealingPool(const std::vector<std::unique_ptr<Search>>& searches)
+    : m_searches(searches), m_queues(), m_threads(), m_quit(false)
+{
+    for (size_t i = 0; i < m_searches.size(); i++)
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    for (unsigned int i = 1; i < m_searches.size(); i++)
+        m_threads.emplace_back(&WorkStealingPool::runWorker, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    m_quit = true;
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void WorkStealingPool::push(unsigned int workerIndex, Task task)
+{
+    std::lock_guard lock(m_queues[workerIndex]->mutex);
+    m_queues[workerIndex]->tasks.push_back(std::move(task));
+}
+
+bool WorkStealingPool::runPendingTask(unsigned int workerIndex)
+{
+    Task task;
+    {
+        auto& queue = *m_queues[workerIndex];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+
+    // Steal oldest task (closest to the root, biggest subtree) of other workers.
+    for (size_t i = 1; i < m_queues.size() && !task; i++) {
+        auto& queue = *m_queues[(workerIndex + i) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+        return false;
+    task(*m_searches[workerIndex]);
+    return true;
+}
+
+void WorkStealingPool::runWorker(unsigned int workerIndex)
+{
+    while (!m_quit) {
+        if (!runPendingTask(workerIndex))
+            std::this_thread::yield();
+    }
+}
+
+} // namespace chessAi
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chessAi
+{
+
+class Search;
+
+/**
+ * Thread pool for split point search (Young Brothers Wait). Every worker owns one search and a
+ * deque of tasks. Worker pushes and pops tasks at the back of its own deque, idle workers steal
+ * from the front of other deques.
+ *
+ * Worker 0 is the thread that constructed the pool (main search thread), it runs tasks only when
+ * calling runPendingTask. Other workers run on threads owned by the pool until it is destroyed.
+ *
+ * https://www.chessprogramming.org/Young_Brothers_Wait_Concept
+ */
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void(Search&)>;
+
+    /**
+     * @param searches Search of each worker, searches must outlive the pool.
+     */
+    explicit WorkStealingPool(const std::vector<std::unique_ptr<Search>>& searches);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void push(unsigned int workerIndex, Task task);
+
+    /**
+     * Run one task with search of the worker. Own deque is checked first, then other deques are
+     * checked for a task to steal.
+     *
+     * @return false if there was no task to run.
+     */
+    bool runPendingTask(unsigned int workerIndex);
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void runWorker(unsigned int workerIndex);
+
+private:
+    const std::vector<std::unique_ptr<Search>>& m_searches;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_quit;
+};
+
+} // namespace chessAi
@@ -39,7 +39,9 @@ uint64_t ZobristHash::calculateZobristKey(const PieceBitBoards& boards)
         }
     }
 
-    key ^= s_enPassantFile[boards.enPassantTargetSquare % 8];
+    // Same as in PieceBitBoards::applyMove, en passant file is hashed only if it is set.
+    if (boards.enPassantTargetSquare != 0)
+        key ^= s_enPassantFile[boards.enPassantTargetSquare % 8];
 
     if (boards.currentMoveColor == PieceColor::Black)
         key ^= s_sideToMove;
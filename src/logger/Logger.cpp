@@ -6,7 +6,7 @@
 namespace chessAi
 {
 
-void Logger::Init()
+void Logger::Init(bool consoleToStderr)
 {
     if (s_logger != nullptr) {
         return;
@@ -14,7 +14,10 @@ void Logger::Init()
 
     try {
         std::vector<std::shared_ptr<spdlog::sinks::sink>> sinks;
-        sinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+        if (consoleToStderr)
+            sinks.emplace_back(std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+        else
+            sinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
         sinks.emplace_back(
             std::make_shared<spdlog::sinks::basic_file_sink_mt>("chessAi_logger.txt", true));
         sinks[0]->set_level(spdlog::level::trace);
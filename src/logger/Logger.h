@@ -14,9 +14,13 @@ class Logger
 {
 public:
     /**
-     * Create a file logger.
+     * Create a logger that writes to a file and to the console. Only the first call (or the first
+     * log) creates it.
+     *
+     * @param consoleToStderr Console output goes to standard error instead of standard output,
+     * which is the UCI channel.
      */
-    static void Init();
+    static void Init(bool consoleToStderr = false);
 
     static std::shared_ptr<spdlog::logger>& getLogger();
 
@@ -1,13 +1,12 @@
-#include <iostream>
-#include <string>
+#include "uci/Interface.h"
 
 int main()
 {
-    std::string input;
-    while (input != "quit") {
-        std::cout << "Enter a string (enter 'quit' to exit): ";
-        std::getline(std::cin, input);
-    }
+    // Standard output is reserved for UCI responses.
+    chessAi::Logger::Init(true);
+
+    chessAi::Interface uciInterface;
+    uciInterface.run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,6 +1,347 @@
 #include "Interface.h"
 
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
 namespace chessAi
 {
 
-} // namespace chessAi
\ No newline at end of file
+namespace
+{
+
+std::vector<std::string> splitInput(const std::string& input)
+{
+    std::vector<std::string> tokens;
+    std::istringstream stream(input);
+    std::string token;
+    while (stream >> token)
+        tokens.push_back(token);
+    return tokens;
+}
+
+std::string positionToField(uint16_t position)
+{
+    return {static_cast<char>('a' + position % 8), static_cast<char>('8' - position / 8)};
+}
+
+std::optional<uint16_t> fieldToPosition(const std::string& field)
+{
+    if (field.length() != 2 || field[0] < 'a' || field[0] > 'h' || field[1] < '1' ||
+        field[1] > '8')
+        return std::nullopt;
+    return static_cast<uint16_t>((field[0] - 'a') + 8 * ('8' - field[1]));
+}
+
+std::string moveToUciNotation(Move move)
+{
+    auto notation = positionToField(move.origin) + positionToField(move.destination);
+    // Promotion 0 to Knight, 1 to Bishop, 2 to Rook, 3 to Queen.
+    if (move.specialMoveFlag == 1)
+        notation += "nbrq"[move.promotion];
+    return notation;
+}
+
+std::optional<Move> uciNotationToMove(const std::string& notation)
+{
+    if (notation.length() != 4 && notation.length() != 5)
+        return std::nullopt;
+    auto origin = fieldToPosition(notation.substr(0, 2));
+    auto destination = fieldToPosition(notation.substr(2, 2));
+    if (!origin.has_value() || !destination.has_value())
+        return std::nullopt;
+    if (notation.length() == 4)
+        return Move(*origin, *destination, 0, 0);
+
+    auto promotion = std::string("nbrq").find(notation[4]);
+    if (promotion == std::string::npos)
+        return std::nullopt;
+    return Move(*origin, *destination, static_cast<uint16_t>(promotion), 1);
+}
+
+std::string scoreToUci(Score score)
+{
+    return (score.type == Score::Type::Mate ? "mate " : "cp ") + std::to_string(score.value);
+}
+
+std::string boundToUciScoreSuffix(TranspositionTable::TypeOfNode bound)
+{
+    if (bound == TranspositionTable::TypeOfNode::lower)
+        return " lowerbound";
+    if (bound == TranspositionTable::TypeOfNode::upper)
+        return " upperbound";
+    return "";
+}
+
+} // namespace
+
+Interface::Interface()
+    : m_boardState(), m_startPosition(true), m_numberOfThreads(1),
+      m_searchMode(SearchMode::LazySmp), m_moveOverhead(s_defaultMoveOverhead), m_ponderReplies(1),
+      m_multiPv(1), m_probCut(true), m_engine(nullptr), m_searchThread()
+{
+}
+
+Interface::~Interface()
+{
+    handleStop();
+}
+
+void Interface::run()
+{
+    std::string input;
+    while (std::getline(std::cin, input)) {
+        if (!parseInput(input))
+            break;
+    }
+    handleStop();
+}
+
+bool Interface::parseInput(const std::string& input)
+{
+    auto tokens = splitInput(input);
+    if (tokens.empty())
+        return true;
+
+    const auto& command = tokens[0];
+    if (command == "uci")
+        handleUci();
+    else if (command == "isready")
+        std::cout << "readyok" << std::endl;
+    else if (command == "setoption")
+        handleSetOption(tokens);
+    else if (command == "ucinewgame")
+        handleNewGame();
+    else if (command == "position")
+        handlePosition(tokens);
+    else if (command == "go")
+        handleGo(tokens);
+    else if (command == "stop")
+        handleStop();
+    else if (command == "ponderhit")
+        handlePonderHit();
+    else if (command == "quit")
+        return false;
+    else
+        CHESS_LOG_WARN("Unknown UCI command: {}", input);
+    return true;
+}
+
+void Interface::handleUci() const
+{
+    std::cout << "id name chessAi" << '\n';
+    std::cout << "id author Rok" << '\n';
+    std::cout << "option name Threads type spin default 1 min 1 max 256" << '\n';
+    // Tells the GUI that engine supports go ponder, pondering is controlled by the GUI.
+    std::cout << "option name Ponder type check default false" << '\n';
+    std::cout << "option name PonderReplies type spin default 1 min 1 max 8" << '\n';
+    std::cout << "option name MultiPV type spin default 1 min 1 max 64" << '\n';
+    std::cout << "option name SearchMode type combo default LazySMP var LazySMP var YBWC" << '\n';
+    std::cout << "option name MoveOverhead type spin default " << s_defaultMoveOverhead.count()
+              << " min 0 max 5000" << '\n';
+    std::cout << "option name ProbCut type check default true" << '\n';
+    std::cout << "option name Clear Hash type button" << '\n';
+    std::cout << "uciok" << std::endl;
+}
+
+void Interface::handleSetOption(const std::vector<std::string>& tokens)
+{
+    // setoption name <id> [value <x>], id can contain spaces, buttons have no value.
+    if (tokens.size() < 3 || tokens[1] != "name") {
+        CHESS_LOG_WARN("Unsupported setoption format.");
+        return;
+    }
+    auto valueIt = std::find(tokens.begin(), tokens.end(), "value");
+    std::string name;
+    for (auto it = tokens.begin() + 2; it != valueIt; it++)
+        name += (name.empty() ? "" : " ") + *it;
+    std::string value = (valueIt != tokens.end() && valueIt + 1 != tokens.end()) ? *(valueIt + 1)
+                                                                                : "";
+
+    if (name == "Threads") {
+        try {
+            m_numberOfThreads = static_cast<unsigned int>(std::clamp(std::stoi(value), 1, 256));
+        }
+        catch (const std::exception& ex) {
+            CHESS_LOG_ERROR("Invalid Threads value: {}", ex.what());
+        }
+    }
+    else if (name == "MoveOverhead") {
+        try {
+            m_moveOverhead = std::chrono::milliseconds(std::clamp(std::stoi(value), 0, 5000));
+        }
+        catch (const std::exception& ex) {
+            CHESS_LOG_ERROR("Invalid MoveOverhead value: {}", ex.what());
+        }
+    }
+    else if (name == "PonderReplies") {
+        try {
+            m_ponderReplies = static_cast<unsigned int>(std::clamp(std::stoi(value), 1, 8));
+        }
+        catch (const std::exception& ex) {
+            CHESS_LOG_ERROR("Invalid PonderReplies value: {}", ex.what());
+        }
+    }
+    else if (name == "MultiPV") {
+        try {
+            m_multiPv = static_cast<unsigned int>(std::clamp(std::stoi(value), 1, 64));
+        }
+        catch (const std::exception& ex) {
+            CHESS_LOG_ERROR("Invalid MultiPV value: {}", ex.what());
+        }
+    }
+    else if (name == "ProbCut")
+        m_probCut = (value == "true");
+    else if (name == "Ponder") {
+        // Nothing to do, GUI sends go ponder when pondering is enabled.
+    }
+    else if (name == "SearchMode") {
+        if (value == "YBWC")
+            m_searchMode = SearchMode::YoungBrothersWait;
+        else
+            m_searchMode = SearchMode::LazySmp;
+    }
+    else if (name == "Clear Hash") {
+        handleStop();
+        if (m_engine != nullptr)
+            m_engine->clear();
+    }
+    else
+        CHESS_LOG_WARN("Unknown option: {}", name);
+}
+
+void Interface::handleNewGame()
+{
+    handleStop();
+    m_boardState = BoardState();
+    if (m_engine != nullptr)
+        m_engine->clear();
+}
+
+void Interface::handlePosition(const std::vector<std::string>& tokens)
+{
+    // position [fen <fenstring> | startpos] moves <move1> .... <movei>
+    size_t movesIndex = tokens.size();
+    for (size_t i = 1; i < tokens.size(); i++) {
+        if (tokens[i] == "moves") {
+            movesIndex = i;
+            break;
+        }
+    }
+
+    if (tokens.size() > 1 && tokens[1] == "fen") {
+        std::string fen;
+        for (size_t i = 2; i < movesIndex; i++)
+            fen += (i == 2 ? "" : " ") + tokens[i];
+        m_boardState = BoardState(fen);
+        m_startPosition = false;
+    }
+    else {
+        m_boardState = BoardState();
+        m_startPosition = true;
+    }
+
+    for (size_t i = movesIndex + 1; i < tokens.size(); i++) {
+        auto move = uciNotationToMove(tokens[i]);
+        if (!move.has_value()) {
+            CHESS_LOG_ERROR("Invalid move notation: {}", tokens[i]);
+            return;
+        }
+        static_cast<void>(m_boardState.updateBoardState(*move));
+    }
+}
+
+void Interface::handleGo(const std::vector<std::string>& tokens)
+{
+    handleStop();
+
+    // Without time parameters (or with infinite) search runs until stop.
+    TimeControl timeControl;
+    unsigned int depthLimit = 100;
+    std::optional<uint64_t> nodeLimit;
+    auto isWhite = m_boardState.getBitBoards().currentMoveColor == PieceColor::White;
+    // Position already contains the expected opponent's move.
+    timeControl.ponder = std::find(tokens.begin(), tokens.end(), "ponder") != tokens.end();
+    try {
+        for (size_t i = 1; i + 1 < tokens.size(); i++) {
+            if (tokens[i] == "movetime")
+                timeControl.moveTime = std::chrono::milliseconds(std::stoll(tokens[i + 1]));
+            else if (tokens[i] == "depth")
+                depthLimit = static_cast<unsigned int>(std::stoul(tokens[i + 1]));
+            else if (tokens[i] == "nodes")
+                nodeLimit = std::stoull(tokens[i + 1]);
+            else if ((tokens[i] == "wtime" && isWhite) || (tokens[i] == "btime" && !isWhite))
+                timeControl.time = std::chrono::milliseconds(std::stoll(tokens[i + 1]));
+            else if ((tokens[i] == "winc" && isWhite) || (tokens[i] == "binc" && !isWhite))
+                timeControl.increment = std::chrono::milliseconds(std::stoll(tokens[i + 1]));
+            else if (tokens[i] == "movestogo")
+                timeControl.movesToGo = static_cast<unsigned int>(std::stoul(tokens[i + 1]));
+        }
+    }
+    catch (const std::exception& ex) {
+        CHESS_LOG_ERROR("Invalid go parameters: {}", ex.what());
+    }
+
+    // Engine and its transposition table are kept between searches, so search after the
+    // opponent's move continues from the previous (or ponder) search.
+    if (m_engine == nullptr)
+        m_engine = std::make_unique<Engine>(true, std::chrono::milliseconds(0), depthLimit);
+    m_engine->setDepthLimit(depthLimit);
+    m_engine->setNodeLimit(nodeLimit);
+    m_engine->setTimeControl(timeControl);
+    m_engine->setPonderReplies(m_ponderReplies);
+    if (timeControl.ponder && m_boardState.getMovesHistory().size() > 0) {
+        auto parentState = m_boardState;
+        parentState.goToPreviousBoardState();
+        m_engine->setPonderParent(parentState.getBitBoards(), parentState.getZobristKeyHistory());
+    }
+    m_engine->setMoveOverhead(m_moveOverhead);
+    m_engine->setNumberOfThreads(m_numberOfThreads);
+    m_engine->setSearchMode(m_searchMode);
+    m_engine->setMultiPv(m_multiPv);
+    m_engine->setProbCut(m_probCut);
+    m_engine->setUseOpeningBook(m_startPosition);
+    m_engine->setInfoCallback([](const SearchInfo& info) {
+        std::cout << "info depth " << info.depth << " multipv " << info.multiPv << " score "
+                  << scoreToUci(info.score) << boundToUciScoreSuffix(info.bound)
+                  << " time " << info.time.count()
+                  << " nodes " << info.nodes << " nps "
+                  << info.nodes * 1000 / (static_cast<uint64_t>(info.time.count()) + 1);
+        if (!info.pv.empty()) {
+            std::cout << " pv";
+            for (auto move : info.pv)
+                std::cout << ' ' << moveToUciNotation(move);
+        }
+        std::cout << std::endl;
+    });
+
+    // Stop of the previous search is cleared here and not on the search thread, so stop received
+    // before the search thread starts searching is not lost.
+    m_engine->prepareSearch();
+    m_searchThread = std::thread([this, bitBoards = m_boardState.getBitBoards(),
+                                  zobristKeysHistory = m_boardState.getZobristKeyHistory(),
+                                  movesHistory = m_boardState.getMovesHistory()]() {
+        auto result = m_engine->findBestMove(bitBoards, zobristKeysHistory, movesHistory);
+        auto ponderMove = m_engine->getPonderMove();
+        std::cout << "bestmove "
+                  << (result.move.has_value() ? moveToUciNotation(*result.move) : "0000")
+                  << (ponderMove.has_value() ? " ponder " + moveToUciNotation(*ponderMove) : "")
+                  << std::endl;
+    });
+}
+
+void Interface::handlePonderHit()
+{
+    if (m_engine != nullptr)
+        m_engine->ponderHit();
+}
+
+void Interface::handleStop()
+{
+    if (m_engine != nullptr)
+        m_engine->stopSearch();
+    if (m_searchThread.joinable())
+        m_searchThread.join();
+}
+
+} // namespace chessAi
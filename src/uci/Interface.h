@@ -1,15 +1,62 @@
 #pragma once
 
 #include "core/BoardState.h"
+#include "core/Engine.h"
 
+#include <memory>
 #include <string>
+#include <thread>
 
 namespace chessAi
 {
 
+/**
+ * Universal Chess Interface, reads commands from standard input and writes responses to standard
+ * output. Search runs on a separate thread, so "stop" can be received while searching.
+ *
+ * http://wbec-ridderkerk.nl/html/UCIProtocol.html
+ */
 class Interface
 {
-    void parseInput(const std::string& input);
+public:
+    Interface();
+    ~Interface();
+
+    /**
+     * Process commands until "quit" is received.
+     */
+    void run();
+
+private:
+    /**
+     * @return false if input was "quit".
+     */
+    bool parseInput(const std::string& input);
+
+    void handleUci() const;
+    void handleSetOption(const std::vector<std::string>& tokens);
+    void handleNewGame();
+    void handlePosition(const std::vector<std::string>& tokens);
+    void handleGo(const std::vector<std::string>& tokens);
+    void handleStop();
+    void handlePonderHit();
+
+private:
+    BoardState m_boardState;
+    // Position was set with startpos, book moves are only looked up from the start position.
+    bool m_startPosition;
+    unsigned int m_numberOfThreads;
+    SearchMode m_searchMode;
+    std::chrono::milliseconds m_moveOverhead;
+    unsigned int m_ponderReplies;
+    unsigned int m_multiPv;
+    bool m_probCut;
+    // Created on first go and kept for the whole session, its transposition table and move
+    // ordering heuristics are cleared on new game.
+    std::unique_ptr<Engine> m_engine;
+    std::thread m_searchThread;
+
+    inline static constexpr std::chrono::milliseconds s_defaultMoveOverhead{10};
 };
 
-} // namespace chessAi
\ No newline at end of file
+} // namespace chessAi
@@ -18,9 +18,12 @@
 #include <gtest/gtest.h>
 
 #include "core/Engine.h"
+#include "core/MoveGenerator.h"
 #include "core/PieceBitBoards.h"
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iostream>
 
 namespace chessAi
@@ -43,67 +46,332 @@ std::vector<std::string> splitString(const std::string& input, char delimiter)
     return tokens;
 }
 
-void runPerformanceTestDepth(int depth, std::string& result)
+/**
+ * Call testPosition with board and FEN of each test position, positions are tested repetitions
+ * times.
+ *
+ * @return Number of tested positions, 0 if the file couldn't be opened.
+ */
+unsigned int forEachTestPosition(
+    const std::function<void(PieceBitBoards& board, const std::string& fen)>& testPosition,
+    int repetitions = 1)
 {
-    std::chrono::milliseconds time(0);
     unsigned int count = 0;
-
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < repetitions; ++i) {
         std::ifstream file("positions/mostly_middle_game_positions.epd");
-        if (!file.is_open())
-            FAIL() << "File with test positions couldn't be opened.";
+        if (!file.is_open()) {
+            ADD_FAILURE() << "File with test positions couldn't be opened.";
+            return 0;
+        }
 
         std::string line;
         while (std::getline(file, line)) {
             auto tokens = splitString(line, ';');
             tokens[0].pop_back();
             PieceBitBoards board(tokens[0]);
+            testPosition(board, tokens[0]);
+            ++count;
+        }
+        file.close();
+    }
+    return count;
+}
 
-            // Initialize here, so transposition tables are cleared (independent results).
-            Engine engine(false, std::chrono::milliseconds(1000000), depth);
+void runPerformanceTestDepth(int depth, std::string& result)
+{
+    std::chrono::milliseconds time(0);
+    uint64_t nodes = 0;
+
+    Engine engine(false, std::chrono::milliseconds(1000000), depth);
+    uint64_t lastNodes = 0;
+    engine.setInfoCallback([&lastNodes](const SearchInfo& info) { lastNodes = info.nodes; });
+    auto count = forEachTestPosition(
+        [&](PieceBitBoards& board, const std::string&) {
+            // Clear the engine, so results are independent.
+            engine.clear();
             auto start = std::chrono::high_resolution_clock::now();
             engine.findBestMove(board, {}, {});
             time += std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::high_resolution_clock::now() - start);
+            nodes += lastNodes;
+        },
+        3);
+    ASSERT_GT(count, 0u);
 
-            ++count;
-        }
-        file.close();
-    }
+    result = "getBestMove(depth = " + std::to_string(depth) +
+             "): average time = " + std::to_string(time.count() / count) +
+             " ms, average nodes = " + std::to_string(nodes / count);
+}
+
+void runPerformanceTestThreads(int depth, unsigned int numberOfThreads, SearchMode searchMode,
+                               std::string& result)
+{
+    std::chrono::milliseconds time(0);
+    uint64_t nodes = 0;
+
+    auto count = forEachTestPosition([&](PieceBitBoards& board, const std::string&) {
+        Engine engine(false, std::chrono::milliseconds(1000000), depth);
+        engine.setNumberOfThreads(numberOfThreads);
+        engine.setSearchMode(searchMode);
+        uint64_t lastNodes = 0;
+        engine.setInfoCallback([&lastNodes](const SearchInfo& info) { lastNodes = info.nodes; });
+        auto start = std::chrono::high_resolution_clock::now();
+        engine.findBestMove(board, {}, {});
+        time += std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+        nodes += lastNodes;
+    });
+    ASSERT_GT(count, 0u);
 
     result = "getBestMove(depth = " + std::to_string(depth) +
-             "): average time = " + std::to_string(time.count() / count) + " ms";
+             ", threads = " + std::to_string(numberOfThreads) +
+             (searchMode == SearchMode::LazySmp ? ", Lazy SMP" : ", YBWC") +
+             "): average time to depth = " + std::to_string(time.count() / count) +
+             " ms, nodes per second = " +
+             std::to_string(nodes * 1000 / (static_cast<uint64_t>(time.count()) + 1));
 }
 
 void runPerformanceTestTime(std::chrono::milliseconds timeLimit, std::string& result)
 {
-    unsigned int count = 0;
     float depthSum = 0;
 
-    for (int i = 0; i < 3; ++i) {
-        std::ifstream file("positions/mostly_middle_game_positions.epd");
-        if (!file.is_open())
-            FAIL() << "File with test positions couldn't be opened.";
-
-        std::string line;
-        while (std::getline(file, line)) {
-            auto tokens = splitString(line, ';');
-            tokens[0].pop_back();
-            PieceBitBoards board(tokens[0]);
-
+    auto count = forEachTestPosition(
+        [&](PieceBitBoards& board, const std::string&) {
             // Initialize here, so transposition tables are cleared.
             Engine engine(false, timeLimit);
-            auto [move, depth] = engine.findBestMove(board, {}, {});
-            depthSum += static_cast<float>(depth);
-            ++count;
-        }
-        file.close();
-    }
+            auto searchResult = engine.findBestMove(board, {}, {});
+            depthSum += static_cast<float>(searchResult.depth);
+        },
+        3);
+    ASSERT_GT(count, 0u);
 
     result = "getBestMove(timeLimit = " + std::to_string(timeLimit.count()) + " ms" +
              "): average depth reached = " + std::to_string(depthSum / static_cast<float>(count));
 }
 
+void runPerformanceTestStopLatency(std::chrono::milliseconds timeLimit, std::string& result)
+{
+    unsigned int count = 0;
+    std::chrono::microseconds latencySum(0);
+    std::chrono::microseconds maxLatency(0);
+
+    forEachTestPosition([&](PieceBitBoards& board, const std::string&) {
+        Engine engine(false, timeLimit);
+        engine.findBestMove(board, {}, {});
+        // Search that ended by itself (shortest mate) has no stop latency.
+        auto latency = engine.getStopLatency();
+        if (!latency.has_value())
+            return;
+        latencySum += *latency;
+        maxLatency = std::max(maxLatency, *latency);
+        ++count;
+    });
+
+    result = "getBestMove(timeLimit = " + std::to_string(timeLimit.count()) + " ms" +
+             "): average stop latency = " +
+             std::to_string(latencySum.count() / std::max(count, 1u)) +
+             " us, max stop latency = " + std::to_string(maxLatency.count()) + " us";
+}
+
+/**
+ * Replays test positions as one game with a simulated clock. Each search gets remaining time and
+ * increment, time used by the search is subtracted from the clock.
+ */
+void runPerformanceTestClock(std::chrono::milliseconds time, std::chrono::milliseconds increment,
+                             bool adaptive, std::string& result)
+{
+    float depthSum = 0;
+    auto clock = time;
+    std::chrono::milliseconds timeUsed(0);
+
+    auto count = forEachTestPosition([&](PieceBitBoards& board, const std::string&) {
+        Engine engine(false, std::chrono::milliseconds(0));
+        TimeControl timeControl;
+        timeControl.time = clock;
+        timeControl.increment = increment;
+        engine.setTimeControl(timeControl);
+        engine.setAdaptiveTimeManagement(adaptive);
+        auto start = std::chrono::steady_clock::now();
+        auto searchResult = engine.findBestMove(board, {}, {});
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        EXPECT_LT(elapsed, clock) << "Lost on time.";
+        clock += increment - elapsed;
+        timeUsed += elapsed;
+        depthSum += static_cast<float>(searchResult.depth);
+    });
+    ASSERT_GT(count, 0u);
+
+    result = "getBestMove(clock = " + std::to_string(time.count()) + " + " +
+             std::to_string(increment.count()) + " ms" +
+             (adaptive ? ", adaptive" : ", fixed soft limit") +
+             "): total time used = " + std::to_string(timeUsed.count()) +
+             " ms, average depth reached = " + std::to_string(depthSum / static_cast<float>(count));
+}
+
+/**
+ * Nodes and time of fixed depth search, with ProbCut enabled or disabled.
+ */
+void runPerformanceTestProbCut(int depth, bool probCut, std::string& result)
+{
+    std::chrono::milliseconds time(0);
+    uint64_t nodes = 0;
+
+    Engine engine(false, std::chrono::milliseconds(1000000), depth);
+    engine.setProbCut(probCut);
+    auto count = forEachTestPosition([&](PieceBitBoards& board, const std::string&) {
+        engine.clear();
+        auto start = std::chrono::high_resolution_clock::now();
+        nodes += engine.findBestMove(board, {}, {}).nodes;
+        time += std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+    });
+    ASSERT_GT(count, 0u);
+
+    result = "getBestMove(depth = " + std::to_string(depth) +
+             (probCut ? ", ProbCut" : ", no ProbCut") +
+             "): average time = " + std::to_string(time.count() / count) +
+             " ms, average nodes = " + std::to_string(nodes / count);
+}
+
+/**
+ * Principal variation of fixed depth search must be legal, start with the best move and continue
+ * with the ponder move.
+ */
+void runPerformanceTestPrincipalVariation(int depth, std::string& result)
+{
+    size_t pvLengthSum = 0;
+
+    Engine engine(false, std::chrono::milliseconds(1000000), depth);
+    auto count = forEachTestPosition([&](PieceBitBoards& board, const std::string& fen) {
+        engine.clear();
+        auto searchResult = engine.findBestMove(board, {}, {});
+        ASSERT_FALSE(searchResult.pv.empty());
+        EXPECT_EQ(searchResult.pv[0], *searchResult.move);
+        if (searchResult.pv.size() > 1)
+            EXPECT_EQ(searchResult.pv[1], *engine.getPonderMove());
+        for (auto move : searchResult.pv) {
+            auto moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(board);
+            ASSERT_NE(std::find(moves.begin(), moves.end(), move), moves.end()) << fen;
+            board.applyMove(move);
+        }
+        pvLengthSum += searchResult.pv.size();
+    });
+    ASSERT_GT(count, 0u);
+
+    result = "getBestMove(depth = " + std::to_string(depth) +
+             "): average principal variation length = " +
+             std::to_string(static_cast<float>(pvLengthSum) / static_cast<float>(count));
+}
+
+/**
+ * Search each test position twice with the same node limit, both searches must stop at the same
+ * node count with the same best move.
+ */
+void runPerformanceTestFixedNodes(uint64_t nodeLimit, std::string& result)
+{
+    float depthSum = 0;
+    uint64_t nodesPerSecondSum = 0;
+
+    auto count = forEachTestPosition([&](PieceBitBoards& board, const std::string&) {
+        // Second search has more threads, node limited search must not depend on them.
+        std::vector<SearchResult> searchResults;
+        for (unsigned int threads : {1u, 4u}) {
+            Engine engine(false, std::chrono::milliseconds(1000000));
+            engine.setNumberOfThreads(threads);
+            engine.setNodeLimit(nodeLimit);
+            searchResults.push_back(engine.findBestMove(board, {}, {}));
+        }
+
+        EXPECT_LE(searchResults[0].nodes, nodeLimit);
+        EXPECT_EQ(searchResults[0].nodes, searchResults[1].nodes);
+        EXPECT_EQ(searchResults[0].move, searchResults[1].move);
+        EXPECT_EQ(searchResults[0].depth, searchResults[1].depth);
+        depthSum += static_cast<float>(searchResults[0].depth);
+        nodesPerSecondSum += searchResults[0].nodesPerSecond;
+    });
+    ASSERT_GT(count, 0u);
+
+    result = "getBestMove(nodeLimit = " + std::to_string(nodeLimit) +
+             "): average depth reached = " + std::to_string(depthSum / static_cast<float>(count)) +
+             ", average nodes per second = " + std::to_string(nodesPerSecondSum / count);
+}
+
+/**
+ * Search each test position, play the best move and the expected reply and search the next
+ * position. Compares nodes of the next search with the same engine (transposition table and move
+ * ordering heuristics of the previous search) and with a new engine.
+ */
+void runPerformanceTestPersistentEngine(int depth, std::string& result)
+{
+    uint64_t persistentNodes = 0;
+    uint64_t newEngineNodes = 0;
+    unsigned int count = 0;
+
+    Engine engine(false, std::chrono::milliseconds(1000000), depth);
+    uint64_t lastNodes = 0;
+    engine.setInfoCallback([&lastNodes](const SearchInfo& info) { lastNodes = info.nodes; });
+    forEachTestPosition([&](PieceBitBoards& board, const std::string&) {
+        auto move = engine.findBestMove(board, {}, {}).move;
+        auto ponderMove = engine.getPonderMove();
+        if (!move.has_value() || !ponderMove.has_value())
+            return;
+        board.applyMove(*move);
+        board.applyMove(*ponderMove);
+
+        engine.findBestMove(board, {}, {});
+        persistentNodes += lastNodes;
+
+        Engine newEngine(false, std::chrono::milliseconds(1000000), depth);
+        newEngine.setInfoCallback([&lastNodes](const SearchInfo& info) { lastNodes = info.nodes; });
+        newEngine.findBestMove(board, {}, {});
+        newEngineNodes += lastNodes;
+        ++count;
+    });
+
+    ASSERT_GT(count, 0u);
+    result = "getBestMove(depth = " + std::to_string(depth) +
+             ", next move): average nodes with persistent engine = " +
+             std::to_string(persistentNodes / count) +
+             ", with new engine = " + std::to_string(newEngineNodes / count);
+}
+
+/**
+ * Average nodes of fixed depth search with multiPv lines, lines of the last depth must have
+ * different moves.
+ */
+void runPerformanceTestMultiPv(int depth, unsigned int multiPv, std::string& result)
+{
+    uint64_t nodes = 0;
+
+    auto count = forEachTestPosition([&](PieceBitBoards& board, const std::string&) {
+        Engine engine(false, std::chrono::milliseconds(1000000), depth);
+        engine.setMultiPv(multiPv);
+        uint64_t lastNodes = 0;
+        std::vector<Move> lineMoves;
+        engine.setInfoCallback([&](const SearchInfo& info) {
+            lastNodes = info.nodes;
+            if (info.depth == static_cast<unsigned int>(depth) && !info.pv.empty() &&
+                info.bound == TranspositionTable::TypeOfNode::exact)
+                lineMoves.push_back(info.pv[0]);
+        });
+        auto move = engine.findBestMove(board, {}, {}).move;
+        nodes += lastNodes;
+
+        EXPECT_EQ(lineMoves.size(), multiPv);
+        for (size_t i = 1; i < lineMoves.size(); i++)
+            EXPECT_EQ(std::count(lineMoves.begin(), lineMoves.end(), lineMoves[i]), 1);
+        if (!lineMoves.empty())
+            EXPECT_EQ(*move, lineMoves[0]);
+    });
+    ASSERT_GT(count, 0u);
+
+    result = "getBestMove(depth = " + std::to_string(depth) +
+             ", multiPV = " + std::to_string(multiPv) +
+             "): average nodes = " + std::to_string(nodes / count);
+}
+
 // The test log is long because of logging in each iteration, scroll to the and to see the result.
 TEST(PerformanceOfFindBestMove, TestFixedDepth)
 {
@@ -112,6 +380,17 @@ TEST(PerformanceOfFindBestMove, TestFixedDepth)
     std::cout << result4 << '\n';
 }
 
+TEST(PerformanceOfFindBestMove, TestTimeToDepthThreads)
+{
+    for (auto searchMode : {SearchMode::LazySmp, SearchMode::YoungBrothersWait}) {
+        for (unsigned int threads : {1, 2, 4}) {
+            std::string result;
+            runPerformanceTestThreads(4, threads, searchMode, result);
+            std::cout << result << '\n';
+        }
+    }
+}
+
 TEST(PerformanceOfFindBestMove, TestFixedTime)
 {
     std::string result;
@@ -119,4 +398,60 @@ TEST(PerformanceOfFindBestMove, TestFixedTime)
     std::cout << result << '\n';
 }
 
+TEST(PerformanceOfFindBestMove, TestFixedNodes)
+{
+    std::string result;
+    runPerformanceTestFixedNodes(100000, result);
+    std::cout << result << '\n';
+}
+
+TEST(PerformanceOfFindBestMove, TestPrincipalVariation)
+{
+    std::string result;
+    runPerformanceTestPrincipalVariation(8, result);
+    std::cout << result << '\n';
+}
+
+TEST(PerformanceOfFindBestMove, TestProbCut)
+{
+    for (bool probCut : {false, true}) {
+        std::string result;
+        runPerformanceTestProbCut(10, probCut, result);
+        std::cout << result << '\n';
+    }
+}
+
+TEST(PerformanceOfFindBestMove, TestStopLatency)
+{
+    std::string result;
+    runPerformanceTestStopLatency(std::chrono::milliseconds(100), result);
+    std::cout << result << '\n';
+}
+
+TEST(PerformanceOfFindBestMove, TestSimulatedClock)
+{
+    for (bool adaptive : {false, true}) {
+        std::string result;
+        runPerformanceTestClock(std::chrono::seconds(10), std::chrono::milliseconds(100),
+                                adaptive, result);
+        std::cout << result << '\n';
+    }
+}
+
+TEST(PerformanceOfFindBestMove, TestPersistentEngine)
+{
+    std::string result;
+    runPerformanceTestPersistentEngine(8, result);
+    std::cout << result << '\n';
+}
+
+TEST(PerformanceOfFindBestMove, TestMultiPv)
+{
+    for (unsigned int multiPv : {1, 3}) {
+        std::string result;
+        runPerformanceTestMultiPv(7, multiPv, result);
+        std::cout << result << '\n';
+    }
+}
+
 } // namespace chessAi
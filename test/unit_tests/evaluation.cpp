@@ -35,4 +35,26 @@ TEST(Evaluation, StartingPositionWithoutPieces)
               0);
 }
 
+TEST(Evaluation, StaticExchangeEvaluation)
+{
+    // Rook takes undefended pawn.
+    EXPECT_EQ(Evaluate::staticExchangeEvaluation(
+                  PieceBitBoards("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1"),
+                  Move(60, 28, 0, 0)),
+              100);
+    // Knight takes pawn, x-ray attackers behind rook, bishop and queen join the exchange.
+    EXPECT_EQ(Evaluate::staticExchangeEvaluation(
+                  PieceBitBoards("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1"),
+                  Move(43, 28, 0, 0)),
+              -200);
+    // Quiet knight move to square attacked by pawn.
+    EXPECT_EQ(Evaluate::staticExchangeEvaluation(
+                  PieceBitBoards("4k3/8/3p4/8/4N3/8/8/4K3 w - - 0 1"), Move(36, 26, 0, 0)),
+              -300);
+    // Quiet knight move to safe square.
+    EXPECT_EQ(Evaluate::staticExchangeEvaluation(
+                  PieceBitBoards("4k3/8/3p4/8/4N3/8/8/4K3 w - - 0 1"), Move(36, 42, 0, 0)),
+              0);
+}
+
 } // namespace chessAi
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include "core/PieceBitBoards.h"
+#include "core/ZobristHash.h"
+
+namespace chessAi
+{
+
+TEST(NullMoveTest, MakeNullMoveFlipsSideAndClearsEnPassant)
+{
+    PieceBitBoards board("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+    PieceBitBoards expected("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3");
+
+    board.makeNullMove();
+
+    EXPECT_EQ(board.currentMoveColor, PieceColor::Black);
+    EXPECT_EQ(board.enPassantTargetSquare, 0);
+    EXPECT_EQ(board.zobristKey, expected.zobristKey);
+    EXPECT_EQ(board.zobristKey, ZobristHash::calculateZobristKey(board));
+}
+
+TEST(NullMoveTest, UnmakeNullMoveRestoresPosition)
+{
+    PieceBitBoards board("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+    PieceBitBoards original = board;
+
+    auto enPassantTargetSquare = board.makeNullMove();
+    board.unmakeNullMove(enPassantTargetSquare);
+
+    EXPECT_EQ(board.currentMoveColor, original.currentMoveColor);
+    EXPECT_EQ(board.enPassantTargetSquare, original.enPassantTargetSquare);
+    EXPECT_EQ(board.halfMoveCount, original.halfMoveCount);
+    EXPECT_EQ(board.zobristKey, original.zobristKey);
+}
+
+TEST(NullMoveTest, NonPawnMaterial)
+{
+    PieceBitBoards board("4k3/pppp4/8/8/8/8/4PPPP/3RK3 w - - 0 1");
+
+    EXPECT_TRUE(board.hasNonPawnMaterial(PieceColor::White));
+    EXPECT_FALSE(board.hasNonPawnMaterial(PieceColor::Black));
+}
+
+} // namespace chessAi
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "core/Engine.h"
+#include "core/MoveGenerator.h"
+#include "core/PieceBitBoards.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace chessAi
+{
+
+TEST(SearchTest, MateScoreIsAdjustedForPlyInTranspositionTable)
+{
+    // White mates in 2: Kc7 Ka7 Ra1#.
+    PieceBitBoards board("k7/8/2K5/8/8/8/8/7R w - - 0 1");
+    Engine engine(false, std::chrono::milliseconds(1000000), 6);
+
+    auto result = engine.findBestMove(board, {}, {});
+    EXPECT_EQ(result.score.type, Score::Type::Mate);
+    EXPECT_EQ(result.score.value, 2);
+
+    // Mate scores stored at deeper plies of the previous search are probed at other plies.
+    result = engine.findBestMove(board, {}, {});
+    EXPECT_EQ(result.score.type, Score::Type::Mate);
+    EXPECT_EQ(result.score.value, 2);
+
+    ASSERT_GE(result.pv.size(), 2u);
+    board.applyMove(result.pv[0]);
+    board.applyMove(result.pv[1]);
+    result = engine.findBestMove(board, {}, {});
+    EXPECT_EQ(result.score.type, Score::Type::Mate);
+    EXPECT_EQ(result.score.value, 1);
+
+    // Side to move gets mated in 2.
+    PieceBitBoards matedBoard("7k/8/5K2/8/8/8/8/R7 b - - 0 1");
+    Engine matedEngine(false, std::chrono::milliseconds(1000000), 6);
+    for (int i = 0; i < 2; i++) {
+        result = matedEngine.findBestMove(matedBoard, {}, {});
+        EXPECT_EQ(result.score.type, Score::Type::Mate);
+        EXPECT_EQ(result.score.value, -2);
+    }
+}
+
+TEST(SearchTest, SingularExtensionsWithSplitPoints)
+{
+    // Pawn on e5 is attacked twice, best is exd4. Depth is above singular extension minimum
+    // depth, so verification searches exclude the table move, also at split points.
+    PieceBitBoards board("r1bqkb1r/pppp1ppp/2n2n2/4p3/3PP3/5N2/PPP2PPP/RNBQKB1R b KQkq - 0 4");
+    for (auto searchMode : {SearchMode::LazySmp, SearchMode::YoungBrothersWait}) {
+        for (unsigned int threads : {1u, 4u}) {
+            Engine engine(false, std::chrono::milliseconds(1000000), 9);
+            engine.setNumberOfThreads(threads);
+            engine.setSearchMode(searchMode);
+            auto result = engine.findBestMove(board, {}, {});
+            ASSERT_TRUE(result.move.has_value());
+            EXPECT_EQ(*result.move, Move(28, 35, 0, 0));
+            EXPECT_EQ(result.score.type, Score::Type::Centipawns);
+            EXPECT_GT(result.score.value, 0);
+        }
+    }
+}
+
+TEST(SearchTest, MultiPvLinesHaveDistinctMoves)
+{
+    // Second position has only 5 legal moves, so there are fewer lines than requested.
+    for (auto [fen, multiPv, expectedLines] :
+         {std::tuple("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3u, 3u),
+          std::tuple("7k/8/8/8/8/8/6PP/7K w - - 0 1", 8u, 5u)}) {
+        PieceBitBoards board(fen);
+        Engine engine(false, std::chrono::milliseconds(1000000), 5);
+        engine.setMultiPv(multiPv);
+        std::vector<Move> lineMoves;
+        engine.setInfoCallback([&lineMoves](const SearchInfo& info) {
+            if (info.depth == 5 && info.bound == TranspositionTable::TypeOfNode::exact) {
+                EXPECT_EQ(info.multiPv, lineMoves.size() + 1);
+                lineMoves.push_back(info.pv[0]);
+            }
+        });
+        auto result = engine.findBestMove(board, {}, {});
+
+        ASSERT_EQ(lineMoves.size(), expectedLines) << fen;
+        EXPECT_EQ(*result.move, lineMoves[0]);
+        for (auto move : lineMoves)
+            EXPECT_EQ(std::count(lineMoves.begin(), lineMoves.end(), move), 1) << fen;
+    }
+}
+
+TEST(SearchTest, PrincipalVariationIsLegal)
+{
+    // Threads help at split points of other threads while they wait at their own.
+    for (auto [fen, searchMode, threads] :
+         {std::tuple("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 8",
+                     SearchMode::LazySmp, 1u),
+          std::tuple("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 8",
+                     SearchMode::YoungBrothersWait, 4u),
+          std::tuple("k7/8/2K5/8/8/8/8/7R w - - 0 1", SearchMode::LazySmp, 1u)}) {
+        PieceBitBoards board(fen);
+        Engine engine(false, std::chrono::milliseconds(1000000), 7);
+        engine.setNumberOfThreads(threads);
+        engine.setSearchMode(searchMode);
+        auto result = engine.findBestMove(board, {}, {});
+
+        ASSERT_GE(result.pv.size(), 2u) << fen;
+        EXPECT_EQ(result.pv[0], *result.move);
+        EXPECT_EQ(result.pv[1], *engine.getPonderMove());
+        for (auto move : result.pv) {
+            auto moves = MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(board);
+            ASSERT_NE(std::find(moves.begin(), moves.end(), move), moves.end()) << fen;
+            board.applyMove(move);
+        }
+        // Mate in 2 is followed to the mate.
+        if (result.score.type == Score::Type::Mate) {
+            EXPECT_EQ(result.pv.size(), 3u);
+            EXPECT_TRUE(MoveGeneratorWrapper::generateLegalMoves<MoveType::Normal>(board).empty());
+        }
+    }
+}
+
+} // namespace chessAi
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "core/Engine.h"
+#include "core/PieceBitBoards.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace chessAi
+{
+
+namespace
+{
+
+/**
+ * Runs the search on another thread, as UCI go does, and sends command from this thread right
+ * after the search thread is started (or before, if commandBeforeStart). Search that doesn't
+ * return in time is ended with ponderhit and stop, so a failing test doesn't hang.
+ *
+ * @return true if the search returned in time.
+ */
+bool searchReturns(Engine& engine, const PieceBitBoards& board,
+                   const std::function<void(Engine&)>& command, bool commandBeforeStart = false)
+{
+    std::atomic<bool> finished(false);
+    engine.prepareSearch();
+    if (commandBeforeStart)
+        command(engine);
+    std::thread searchThread([&engine, &board, &finished]() {
+        engine.findBestMove(board, {}, {});
+        finished = true;
+    });
+    if (!commandBeforeStart)
+        command(engine);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!finished && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    bool returned = finished;
+    if (!returned) {
+        engine.ponderHit();
+        engine.stopSearch();
+    }
+    searchThread.join();
+    return returned;
+}
+
+TimeControl ponderTimeControl()
+{
+    TimeControl timeControl;
+    timeControl.ponder = true;
+    timeControl.moveTime = std::chrono::milliseconds(100);
+    return timeControl;
+}
+
+const PieceBitBoards s_board("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 8");
+
+} // namespace
+
+TEST(SearchControlTest, GoInfiniteThenStop)
+{
+    Engine engine(false, std::chrono::milliseconds(0));
+    engine.setTimeControl(TimeControl());
+    for (int i = 0; i < 10; i++)
+        EXPECT_TRUE(searchReturns(engine, s_board, [](Engine& e) { e.stopSearch(); }));
+}
+
+TEST(SearchControlTest, StopBeforeSearchStarts)
+{
+    Engine engine(false, std::chrono::milliseconds(0));
+    engine.setTimeControl(TimeControl());
+    EXPECT_TRUE(searchReturns(engine, s_board, [](Engine& e) { e.stopSearch(); }, true));
+
+    engine.setTimeControl(ponderTimeControl());
+    EXPECT_TRUE(searchReturns(engine, s_board, [](Engine& e) { e.stopSearch(); }, true));
+}
+
+TEST(SearchControlTest, GoPonderThenStop)
+{
+    Engine engine(false, std::chrono::milliseconds(0));
+    for (int i = 0; i < 10; i++) {
+        engine.setTimeControl(ponderTimeControl());
+        EXPECT_TRUE(searchReturns(engine, s_board, [](Engine& e) { e.stopSearch(); }));
+    }
+}
+
+TEST(SearchControlTest, GoPonderThenPonderHit)
+{
+    Engine engine(false, std::chrono::milliseconds(0));
+    for (int i = 0; i < 10; i++) {
+        engine.setTimeControl(ponderTimeControl());
+        EXPECT_TRUE(searchReturns(engine, s_board, [](Engine& e) { e.ponderHit(); }));
+    }
+}
+
+TEST(SearchControlTest, GoPonderOnBookMoveThenStop)
+{
+    // Start position with empty moves history is in the book.
+    Engine engine(true, std::chrono::milliseconds(0));
+    PieceBitBoards board;
+    for (auto command : {std::function<void(Engine&)>([](Engine& e) { e.stopSearch(); }),
+                         std::function<void(Engine&)>([](Engine& e) { e.ponderHit(); })}) {
+        engine.setTimeControl(ponderTimeControl());
+        EXPECT_TRUE(searchReturns(engine, board, command));
+    }
+}
+
+} // namespace chessAi
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include "core/TimeManager.h"
+
+#include <thread>
+
+namespace chessAi
+{
+
+namespace
+{
+
+TimeControl clockTimeControl(int time, int increment = 0, unsigned int movesToGo = 0)
+{
+    TimeControl timeControl;
+    timeControl.time = std::chrono::milliseconds(time);
+    timeControl.increment = std::chrono::milliseconds(increment);
+    timeControl.movesToGo = movesToGo;
+    return timeControl;
+}
+
+} // namespace
+
+TEST(TimeManagerTest, NoLimitsWithoutTime)
+{
+    TimeManager timeManager;
+    timeManager.start(TimeControl());
+
+    EXPECT_FALSE(timeManager.getSoftLimit().has_value());
+    EXPECT_FALSE(timeManager.getHardLimit().has_value());
+    EXPECT_FALSE(timeManager.softLimitReached());
+    EXPECT_FALSE(timeManager.hardLimitReached());
+}
+
+TEST(TimeManagerTest, MoveTime)
+{
+    TimeManager timeManager(std::chrono::milliseconds(50));
+    TimeControl timeControl;
+    timeControl.moveTime = std::chrono::milliseconds(1000);
+    // Remaining time is ignored with move time.
+    timeControl.time = std::chrono::milliseconds(100);
+    timeManager.start(timeControl);
+
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(950));
+    EXPECT_EQ(timeManager.getHardLimit(), std::chrono::milliseconds(950));
+
+    // Overhead larger than move time still leaves 1 ms.
+    timeControl.moveTime = std::chrono::milliseconds(10);
+    timeManager.start(timeControl);
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1));
+    EXPECT_EQ(timeManager.getHardLimit(), std::chrono::milliseconds(1));
+}
+
+TEST(TimeManagerTest, SuddenDeath)
+{
+    TimeManager timeManager;
+    timeManager.start(clockTimeControl(40000));
+
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1000));
+    EXPECT_EQ(timeManager.getHardLimit(), std::chrono::milliseconds(5000));
+}
+
+TEST(TimeManagerTest, MovesToGo)
+{
+    TimeManager timeManager;
+    timeManager.start(clockTimeControl(10000, 0, 10));
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1000));
+    EXPECT_EQ(timeManager.getHardLimit(), std::chrono::milliseconds(5000));
+
+    // Moves to go is capped, time is spread over at most 50 moves.
+    timeManager.start(clockTimeControl(50000, 0, 100));
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1000));
+}
+
+TEST(TimeManagerTest, Increment)
+{
+    TimeManager timeManager;
+    timeManager.start(clockTimeControl(40000, 1000));
+
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1750));
+    EXPECT_EQ(timeManager.getHardLimit(), std::chrono::milliseconds(8750));
+}
+
+TEST(TimeManagerTest, MoveOverhead)
+{
+    TimeManager timeManager;
+    timeManager.setMoveOverhead(std::chrono::milliseconds(50));
+    timeManager.start(clockTimeControl(40050));
+
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1000));
+    EXPECT_EQ(timeManager.getHardLimit(), std::chrono::milliseconds(5000));
+}
+
+TEST(TimeManagerTest, LowTimeWithLargeIncrement)
+{
+    TimeManager timeManager;
+    timeManager.start(clockTimeControl(1000, 2000));
+
+    // Hard limit is at most 80 % of remaining time, soft limit is at most hard limit.
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(800));
+    EXPECT_EQ(timeManager.getHardLimit(), std::chrono::milliseconds(800));
+}
+
+TEST(TimeManagerTest, StabilityFactorIsClamped)
+{
+    TimeManager timeManager;
+    timeManager.start(clockTimeControl(40000));
+
+    // Best move never changes and gets all root nodes.
+    for (int i = 0; i < 10; i++)
+        timeManager.onIterationCompleted(Move(12, 28, 0, 0), 0, 1.0);
+    // Minimal stability factor 0.6, nodes factor 0.5.
+    EXPECT_NEAR(timeManager.getSoftLimit()->count(), 300, 1);
+}
+
+TEST(TimeManagerTest, ScoreTrendFactorIsClamped)
+{
+    TimeManager timeManager;
+    timeManager.start(clockTimeControl(40000));
+
+    // Evaluation drop, unstable best move, nodes factor 0.5.
+    timeManager.onIterationCompleted(Move(12, 28, 0, 0), 0, 1.0);
+    timeManager.onIterationCompleted(Move(11, 27, 0, 0), -1000, 1.0);
+    EXPECT_NEAR(timeManager.getSoftLimit()->count(), 1000 * 1.3 * 0.5 * 1.5, 1);
+
+    // Evaluation rise.
+    timeManager.onIterationCompleted(Move(12, 28, 0, 0), 1000, 1.0);
+    EXPECT_NEAR(timeManager.getSoftLimit()->count(), 1000 * 1.3 * 0.5 * 0.9, 1);
+}
+
+TEST(TimeManagerTest, ScaledSoftLimitIsAtMostHardLimit)
+{
+    TimeManager timeManager;
+    timeManager.start(clockTimeControl(1000, 2000));
+
+    timeManager.onIterationCompleted(Move(12, 28, 0, 0), 0, 0.0);
+    timeManager.onIterationCompleted(Move(11, 27, 0, 0), -1000, 0.0);
+    EXPECT_EQ(timeManager.getSoftLimit(), timeManager.getHardLimit());
+}
+
+TEST(TimeManagerTest, SoftLimitNotScaled)
+{
+    TimeManager timeManager;
+    TimeControl timeControl;
+    timeControl.moveTime = std::chrono::milliseconds(1000);
+    timeManager.start(timeControl);
+    timeManager.onIterationCompleted(Move(12, 28, 0, 0), 0, 1.0);
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1000));
+
+    timeManager.setAdaptive(false);
+    timeManager.start(clockTimeControl(40000));
+    timeManager.onIterationCompleted(Move(12, 28, 0, 0), 0, 1.0);
+    EXPECT_EQ(timeManager.getSoftLimit(), std::chrono::milliseconds(1000));
+}
+
+TEST(TimeManagerTest, LimitsNotReachedWhilePondering)
+{
+    TimeManager timeManager;
+    TimeControl timeControl;
+    timeControl.moveTime = std::chrono::milliseconds(1);
+    timeManager.setPondering(true);
+    timeManager.start(timeControl);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    EXPECT_FALSE(timeManager.softLimitReached());
+    EXPECT_FALSE(timeManager.hardLimitReached());
+    timeManager.setPondering(false);
+    EXPECT_TRUE(timeManager.softLimitReached());
+    EXPECT_TRUE(timeManager.hardLimitReached());
+}
+
+} // namespace chessAi
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include "core/Evaluate.h"
+#include "core/TranspositionTable.h"
+
+namespace chessAi
+{
+
+namespace
+{
+
+constexpr uint64_t s_key = 0x123456789ABCDEF0;
+// Key of a different position in the same slot, keys are mapped to slots modulo table size.
+constexpr uint64_t s_collidingKey = s_key + 3532045;
+
+const Move s_move(12, 28, 0, 0);
+
+} // namespace
+
+TEST(TranspositionTableTest, StoreAndProbe)
+{
+    TranspositionTable table;
+    EXPECT_FALSE(table.getEntry(s_key).has_value());
+
+    // Negative (mate) scores and depth above 255 survive packing.
+    table.store(s_key, -Evaluate::mateScore + 3, 300, TranspositionTable::TypeOfNode::upper,
+                s_move);
+    auto entry = table.getEntry(s_key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->evaluation, -Evaluate::mateScore + 3);
+    EXPECT_EQ(entry->depth, 255u);
+    EXPECT_EQ(entry->typeOfNode, TranspositionTable::TypeOfNode::upper);
+    EXPECT_EQ(entry->bestMove, s_move);
+    EXPECT_FALSE(table.getEntry(s_collidingKey).has_value());
+}
+
+TEST(TranspositionTableTest, DeepEntryOfCurrentSearchIsKept)
+{
+    TranspositionTable table;
+    table.newSearch();
+    table.store(s_key, 10, 10, TranspositionTable::TypeOfNode::exact, s_move);
+
+    table.store(s_collidingKey, 20, 2, TranspositionTable::TypeOfNode::exact, s_move);
+    EXPECT_FALSE(table.getEntry(s_collidingKey).has_value());
+    ASSERT_TRUE(table.getEntry(s_key).has_value());
+    EXPECT_EQ(table.getEntry(s_key)->depth, 10u);
+
+    // Not much shallower search replaces it.
+    table.store(s_collidingKey, 20, 7, TranspositionTable::TypeOfNode::exact, s_move);
+    EXPECT_FALSE(table.getEntry(s_key).has_value());
+    ASSERT_TRUE(table.getEntry(s_collidingKey).has_value());
+    EXPECT_EQ(table.getEntry(s_collidingKey)->depth, 7u);
+}
+
+TEST(TranspositionTableTest, SamePositionIsAlwaysReplaced)
+{
+    TranspositionTable table;
+    table.store(s_key, 10, 10, TranspositionTable::TypeOfNode::exact, s_move);
+    table.store(s_key, 20, 1, TranspositionTable::TypeOfNode::lower, s_move);
+
+    auto entry = table.getEntry(s_key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->evaluation, 20);
+    EXPECT_EQ(entry->depth, 1u);
+}
+
+TEST(TranspositionTableTest, EntryOfPreviousSearchIsReplaced)
+{
+    TranspositionTable table;
+    table.store(s_key, 10, 20, TranspositionTable::TypeOfNode::exact, s_move);
+    auto generation = table.getEntry(s_key)->generation;
+
+    table.newSearch();
+    // Entries of previous searches are still probed.
+    ASSERT_TRUE(table.getEntry(s_key).has_value());
+    table.store(s_collidingKey, 20, 1, TranspositionTable::TypeOfNode::exact, s_move);
+
+    EXPECT_FALSE(table.getEntry(s_key).has_value());
+    auto entry = table.getEntry(s_collidingKey);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_NE(entry->generation, generation);
+}
+
+TEST(TranspositionTableTest, ClearRemovesEntries)
+{
+    TranspositionTable table;
+    table.store(s_key, 10, 10, TranspositionTable::TypeOfNode::exact, s_move);
+    table.clear();
+
+    EXPECT_FALSE(table.getEntry(s_key).has_value());
+}
+
+} // namespace chessAi